@@ -0,0 +1,135 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Bounded cache of the solution counts of frontier Components, shared
+     * between moves and games.
+     * 
+     * Components are keyed by their constraint structure alone. Cells are
+     * numbered in coordinate order, so the same shape anywhere on any board
+     * has the same key and the same counts. The least recently used entry
+     * is evicted once the cache is full. All operations are thread safe.
+     */
+    class ComponentCache {
+    public:
+        using Key = std::vector<unsigned int>;
+
+    private:
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        using Entry = std::pair<Key, Counts>;
+
+        std::size_t _capacity;
+        std::list<Entry> _entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+        unsigned long long _hits = 0, _misses = 0;
+        mutable std::mutex _mutex;
+
+    public:
+        // Components with more cells than this aren't cached
+        static constexpr unsigned int max_cells = 24;
+
+        /**
+         * Create a cache holding up to `capacity` components.
+         * 
+         * @param capacity maximum number of components to hold
+         */
+        ComponentCache(std::size_t capacity);
+
+        /**
+         * Create a cache holding the same components as `other`, which is
+         * locked while they are copied.
+         * 
+         * @param other cache to copy
+         */
+        ComponentCache(const ComponentCache& other);
+
+        ComponentCache& operator=(const ComponentCache& other);
+
+        /**
+         * Get the cache shared by the whole process, which solvers only use
+         * when given it.
+         * 
+         * @return process wide cache
+         */
+        static std::shared_ptr<ComponentCache> shared();
+
+        /**
+         * Get the canonical encoding of a component's constraint structure:
+         * its cell count, then each constraint's mines and cells, with the
+         * constraints in sorted order.
+         * 
+         * @param component component to encode
+         * 
+         * @return key of the component
+         */
+        static Key key(const Component& component);
+
+        /**
+         * Look up the counts of a component, counting a hit or a miss.
+         * 
+         * @param key key of the component
+         * 
+         * @return the component's counts, or no value if it isn't cached
+         */
+        std::optional<Counts> find(const Key& key);
+
+        /**
+         * Add the counts of a component, evicting the least recently used
+         * component if the cache is full.
+         * 
+         * @param key key of the component
+         * @param counts solution counts of the component
+         */
+        void insert(const Key& key, const Counts& counts);
+
+        /**
+         * Remove every component and reset the hit and miss counters.
+         */
+        void clear();
+
+        /**
+         * Get the number of components held.
+         * 
+         * @return number of cached components
+         */
+        std::size_t size() const;
+
+        /**
+         * Get the maximum number of components held.
+         * 
+         * @return capacity of the cache
+         */
+        std::size_t capacity() const;
+
+        /**
+         * Get the number of lookups which found their component.
+         * 
+         * @return number of hits
+         */
+        unsigned long long hits() const;
+
+        /**
+         * Get the number of lookups which didn't find their component.
+         * 
+         * @return number of misses
+         */
+        unsigned long long misses() const;
+
+        /**
+         * Get the fraction of lookups which found their component.
+         * 
+         * @return hit rate, or 0 if there haven't been any lookups
+         */
+        double hit_rate() const;
+    };
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Components of the hint edge and their solution counts, kept up to
+     * date from the nodes each move changed, so that only the components
+     * around a move are rebuilt and counted again.
+     * 
+     * A component can only change if one of its cells or hints changed, or
+     * is next to a changed node: a hint's constraint only changes with its
+     * neighbours, and components only merge through a new hint, whose
+     * cells are next to it, or a cell covered again, whose hints are next
+     * to it. Those components are dirty, and are rebuilt from their hints
+     * and the hints next to the changed nodes. Every other component keeps
+     * its entry and counts.
+     */
+    class ComponentTracker {
+        struct Entry {
+            Component component;
+
+            // exact counts of the component, or no value while dirty
+            std::optional<Counts> counts;
+        };
+
+        using Coord = std::pair<unsigned int, unsigned int>;
+
+        // components of the hint edge, by the coordinates of their first
+        // cell, which is the order of frontier::components
+        std::map<Coord, Entry> entries;
+
+        // first cell of the component each cell and hint is in
+        std::unordered_map<Node*, Coord> owners;
+
+        // log of changed nodes of the state tracked, and how much of it has
+        // been applied
+        std::weak_ptr<const std::vector<Node*>> log;
+        std::size_t applied = 0;
+
+        unsigned long long _reused = 0, _counted = 0;
+
+        void insert(const std::vector<Component>& components);
+
+        void erase(const Coord& first);
+
+    public:
+        /**
+         * Bring the tracked components up to date with the hint edge. If the
+         * log is the one of the last call, only the components around the
+         * nodes changed since are rebuilt. Otherwise every component is.
+         * 
+         * @param hint_edge hint nodes adjacent to a covered node
+         * @param changes log of the nodes whose value changed, as given by
+         *      SolverState::changes
+         * 
+         * @return components of the hint edge, in the order of
+         *      frontier::components
+         */
+        std::vector<Component> components(const std::set<Node*>& hint_edge, const std::shared_ptr<const std::vector<Node*>>& changes);
+
+        /**
+         * Look up the counts of the given components, as returned by the
+         * last call to `components`.
+         * 
+         * @param components components of the hint edge
+         * 
+         * @return counts of each clean component, or no value for each
+         *      dirty one
+         */
+        std::vector<std::optional<Counts>> find(const std::vector<Component>& components);
+
+        /**
+         * Keep the counts of the given components. Components without
+         * counts, e.g. estimated ones, are left dirty.
+         * 
+         * @param components components of the hint edge
+         * @param counts exact counts of each component, if known
+         */
+        void update(const std::vector<Component>& components, const std::vector<std::optional<Counts>>& counts);
+
+        /**
+         * Forget every tracked component.
+         */
+        void clear();
+
+        /**
+         * Get the number of components whose counts were reused by `find`.
+         * 
+         * @return number of clean components found
+         */
+        unsigned long long reused() const;
+
+        /**
+         * Get the number of components `find` found dirty.
+         * 
+         * @return number of dirty components found
+         */
+        unsigned long long counted() const;
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <solver/node.hpp>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Exact solver for the end of a game, when few cells are covered.
+     * 
+     * Every placement of the mines left in the covered cells which agrees
+     * with every hint is enumerated as a bitboard, so each is equally
+     * likely. The game tree over those placements is then searched: a
+     * reveal splits the placements it survives by the hint it would show,
+     * and the move with the best chance of winning the game is picked.
+     * Positions are remembered in a transposition table, keyed by the
+     * placements still possible and the cells revealed.
+     */
+    class EndgameSolver {
+    public:
+        using Board = std::uint64_t;
+
+        // Most covered cells an endgame may have
+        static constexpr unsigned int max_cells = 40;
+
+        // Most mine placements an endgame may have
+        static constexpr unsigned int max_solutions = 4096;
+
+        /**
+         * Best move of an endgame.
+         */
+        struct Move {
+            Node* node;
+
+            // chance of winning the game by revealing `node`, then playing
+            // the best moves
+            double win_probability;
+        };
+
+    private:
+        unsigned long _max_positions;
+        std::size_t _positions = 0;
+        std::vector<Board> _solutions;
+
+    public:
+        /**
+         * Create an endgame solver which searches up to `max_positions`
+         * positions per move.
+         * 
+         * @param max_positions size of the transposition table to give up at
+         */
+        EndgameSolver(unsigned long max_positions = 1UL << 16);
+
+        /**
+         * Find the move with the best chance of winning.
+         * 
+         * @param covered all covered cells of the board
+         * @param mines_left number of mines not yet flagged
+         * 
+         * @return best move, or no value if the board isn't an endgame:
+         *      there are more than `max_cells` covered cells or
+         *      `max_solutions` mine placements, no placement at all, or more
+         *      than `max_positions` positions to search
+         */
+        std::optional<Move> solve(const std::set<Node*>& covered, int mines_left);
+
+        /**
+         * Get the mine placements of the covered cells found by the last
+         * call to `solve`, with bit i set if the i-th covered cell is a mine.
+         * 
+         * @return mine placements of the last endgame
+         */
+        const std::vector<Board>& solutions() const;
+
+        /**
+         * Get the number of positions searched by the last call to `solve`.
+         * 
+         * @return size of the transposition table
+         */
+        std::size_t positions() const;
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+#include <solver/thread_pool.hpp>
+#include <solver/component_cache.hpp>
+#include <solver/patterns.hpp>
+#include <chrono>
+#include <optional>
+#include <random>
+
+namespace minesweeper::solver::frontier {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Exact solution counter for frontier Components.
+     * 
+     * Searches the assignments of a component's cells depth first. Cells are
+     * branched on in an order that keeps constraints closing early, and
+     * every assignment is followed by propagation of the constraints it
+     * completes, so dead ends are pruned as soon as they appear.
+     * 
+     * Given a ThreadPool, the search trees of large components are split on
+     * their first branches into tasks, which run alongside the other
+     * components. Counts are merged in a fixed order, so the results are the
+     * same as counting on a single thread.
+     * 
+     * Given a PatternDatabase or ComponentCache, components they hold are
+     * looked up instead of being searched again.
+     */
+    class BacktrackingEnumerator {
+        std::shared_ptr<ThreadPool> _pool;
+        std::shared_ptr<ComponentCache> _cache;
+        std::shared_ptr<const PatternDatabase> _patterns;
+        unsigned long long _nodes_visited = 0;
+
+        std::vector<std::optional<Counts>> count_all(const std::vector<Component>& components, std::optional<Clock::time_point> deadline);
+
+        std::vector<std::optional<Counts>> search_all(const std::vector<Component>& components, std::optional<Clock::time_point> deadline);
+
+    public:
+        /**
+         * Create an enumerator which counts on the given pool's threads.
+         * 
+         * @param pool thread pool to run on, or nullptr to count on the
+         *      calling thread
+         */
+        BacktrackingEnumerator(std::shared_ptr<ThreadPool> pool = nullptr);
+
+        /**
+         * Look up and store the counts of components in the given cache when
+         * counting several components.
+         * 
+         * @param cache cache to use, or nullptr to always search
+         */
+        void set_cache(std::shared_ptr<ComponentCache> cache);
+
+        /**
+         * Get the cache components are looked up in.
+         * 
+         * @return cache of the enumerator, or nullptr if it has none
+         */
+        const std::shared_ptr<ComponentCache>& cache() const;
+
+        /**
+         * Look up the counts of components in the given pattern database,
+         * before the cache, when counting several components.
+         * 
+         * @param patterns pattern database to use, or nullptr for none
+         */
+        void set_patterns(std::shared_ptr<const PatternDatabase> patterns);
+
+        /**
+         * Count the solutions of `component` by the number of mines used.
+         * 
+         * @param component component to count the solutions of
+         * 
+         * @return solution counts of `component`
+         */
+        Counts count(const Component& component);
+
+        /**
+         * Count the solutions of each of the given components, in parallel if
+         * the enumerator has a thread pool.
+         * 
+         * @param components components to count the solutions of
+         * 
+         * @return solution counts of each component
+         */
+        std::vector<Counts> count(const std::vector<Component>& components);
+
+        /**
+         * Count the solutions of each of the given components, giving up on
+         * any component which hasn't been counted by the deadline.
+         * 
+         * @param components components to count the solutions of
+         * @param deadline time to stop counting at
+         * 
+         * @return solution counts of each component, or no value for
+         *      components which weren't counted in time
+         */
+        std::vector<std::optional<Counts>> count_until(const std::vector<Component>& components, Clock::time_point deadline);
+
+        /**
+         * Get the number of search tree nodes visited by all calls to `count`.
+         * 
+         * @return number of search tree nodes visited
+         */
+        unsigned long long nodes_visited() const;
+    };
+
+    /**
+     * Estimated solution counts of a Component.
+     */
+    struct Estimate {
+        // unbiased estimate of the solution counts
+        Counts counts;
+
+        // half width of the 95% confidence interval of each cell's
+        // probability of being a mine, before weighting by mines left
+        std::vector<double> margins;
+
+        // number of random probes the estimate is made from
+        unsigned long probes = 0;
+    };
+
+    /**
+     * Solution count estimator for Components too large to count exactly.
+     * 
+     * Each probe walks a single random path down the same search tree as
+     * BacktrackingEnumerator, picking uniformly between the branches which
+     * survive propagation. A solution reached this way is weighted by the
+     * product of the number of branches it chose between, which makes the
+     * average of many probes an unbiased estimate of the solution counts.
+     */
+    class ProbeEstimator {
+        std::mt19937_64 _rng;
+
+    public:
+        /**
+         * Create an estimator with the given RNG seed.
+         * 
+         * @param seed seed of the estimator's RNG
+         */
+        ProbeEstimator(unsigned long seed);
+
+        /**
+         * Estimate the solutions of `component` from random probes, probing
+         * until the deadline or `max_probes` have been made.
+         * 
+         * @param component component to estimate the solutions of
+         * @param deadline time to stop probing at
+         * @param min_probes number of probes to make even if the deadline
+         *      has passed
+         * @param max_probes maximum number of probes to make
+         * 
+         * @return estimated solution counts of `component`
+         */
+        Estimate estimate(const Component& component, Clock::time_point deadline, unsigned long min_probes, unsigned long max_probes);
+    };
+
+    /**
+     * Find a solution of `component`, chosen at random when one can be found
+     * by a few random probes, otherwise the first found by a full search.
+     * 
+     * @param component component to find a solution of
+     * @param rng random number generator to choose the solution with
+     * 
+     * @return whether each cell is a mine in the solution, or no value if
+     *      the component has no solution
+     */
+    std::optional<std::vector<bool>> random_solution(const Component& component, std::mt19937_64& rng);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <solver/node.hpp>
+#include <solver/numeric.hpp>
+#include <vector>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Constraint from a hint tile that exactly `mines` of the covered cells
+     * at the given indices are mines.
+     */
+    struct Constraint {
+        std::vector<unsigned int> cells;
+        unsigned int mines;
+    };
+
+    /**
+     * A group of covered edge cells that are connected through the hints
+     * adjacent to them. The cells of different components can be solved
+     * independently of each other.
+     */
+    struct Component {
+        std::vector<Node*> cells;
+        std::vector<Constraint> constraints;
+    };
+
+    /**
+     * Number of solutions of a Component, bucketed by the number of mines
+     * used. Counts are whole numbers, but are stored as doubles so that
+     * large components don't overflow.
+     */
+    struct Counts {
+        // solutions[k] is the number of solutions with exactly k mines
+        std::vector<double> solutions;
+
+        // cell_mines[i][k] is the number of solutions with exactly k mines
+        // in which cell i is a mine
+        std::vector<std::vector<double>> cell_mines;
+
+        /**
+         * Create empty counts for a component with `cell_count` cells.
+         * 
+         * @param cell_count number of cells in the component
+         */
+        Counts(unsigned int cell_count = 0);
+
+        /**
+         * Get the total number of solutions, regardless of mines used.
+         * 
+         * @return number of solutions
+         */
+        double total() const;
+
+        /**
+         * Get the number of solutions in which cell `i` is a mine,
+         * regardless of mines used.
+         * 
+         * @param i index of the cell
+         * 
+         * @return number of solutions where cell `i` is a mine
+         */
+        double cell_total(unsigned int i) const;
+
+        /**
+         * Add the counts of `other`, e.g. the solutions of another part of
+         * the same component's search.
+         * 
+         * @param other counts for the same number of cells
+         * 
+         * @return these counts
+         */
+        Counts& operator+=(const Counts& other);
+    };
+
+    /**
+     * Split the covered cells adjacent to the given hints into components.
+     * 
+     * Hints with no adjacent covered cells are ignored. Cells within a
+     * component are ordered by coordinate.
+     * 
+     * @param hint_edge hint nodes adjacent to at least one covered node
+     * 
+     * @return list of components
+     */
+    std::vector<Component> components(const std::set<Node*>& hint_edge);
+
+    /**
+     * Mine probabilities of the covered cells on and off the frontier.
+     */
+    template <typename Number>
+    struct BasicProbabilities {
+        // cells[c][i] is the probability that cell i of component c is a mine
+        std::vector<std::vector<Number>> cells;
+
+        // probability that a covered cell not on the frontier is a mine
+        Number interior;
+
+        // whether the number of mines left could be used to weight solutions
+        bool weighted;
+    };
+
+    using Probabilities = BasicProbabilities<double>;
+
+    /**
+     * Combine the solution counts of every component of the frontier with
+     * the number of mines left on the board.
+     * 
+     * A frontier solution using k mines leaves mines_left - k mines for the
+     * interior, which can be placed in C(interior_cells, mines_left - k)
+     * ways, so each solution is weighted by that many boards. Weights are
+     * calculated in log space and the components are convolved together, so
+     * large boards don't overflow.
+     * 
+     * If no combination of component solutions can use up the mines left
+     * (e.g. only part of a board is known), solutions are not weighted.
+     * 
+     * @param counts solution counts of each component
+     * @param interior_cells number of covered cells not on the frontier
+     * @param mines_left number of mines not yet flagged
+     * 
+     * @return mine probabilities of the frontier and interior cells
+     */
+    Probabilities combine(const std::vector<Counts>& counts, unsigned int interior_cells, int mines_left);
+
+    /**
+     * Combine the solution counts of every component of the frontier with
+     * the number of mines left on the board, calculating in the number type
+     * of the given numeric policy, e.g. numeric::Exact.
+     * 
+     * @param counts solution counts of each component
+     * @param interior_cells number of covered cells not on the frontier
+     * @param mines_left number of mines not yet flagged
+     * 
+     * @return mine probabilities of the frontier and interior cells
+     */
+    template <typename Numeric>
+    BasicProbabilities<typename Numeric::value_type> combine(const std::vector<Counts>& counts, unsigned int interior_cells, int mines_left);
+}
\ No newline at end of file
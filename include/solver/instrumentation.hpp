@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace minesweeper::solver {
+    // Whether the solvers count and time their work. Set by building with
+    // the MINESWEEPER_INSTRUMENTATION option, otherwise the counting is
+    // compiled out
+#ifdef MINESWEEPER_INSTRUMENTATION
+    constexpr bool instrumented = true;
+#else
+    constexpr bool instrumented = false;
+#endif
+
+    // Stage of the game solver which chose a move
+    enum class Phase {
+        // First uncover of the game, with nothing to go on
+        Opening,
+        Basic,
+        Advanced,
+        Probable
+    };
+
+    /**
+     * Get the lower case name of a stage, e.g. for JSON keys.
+     * 
+     * @param phase stage to name
+     * 
+     * @return name of `phase`
+     */
+    const char* phase_name(Phase phase);
+
+    // Time spent and moves made by one stage of the game solver
+    struct PhaseStats {
+        // number of times the stage was entered
+        unsigned long long passes = 0;
+
+        std::chrono::nanoseconds time { 0 };
+
+        unsigned int moves = 0;
+    };
+
+    // Work done counting mine placements, summed over every call
+    struct CountingStats {
+        // systems of linear equations brute forced, and their total
+        // numbers of equations and independent variables
+        unsigned long long systems = 0;
+        unsigned long long equations = 0;
+        unsigned long long independent_variables = 0;
+
+        // nodes of the backtracking search visited
+        unsigned long long nodes_visited = 0;
+    };
+
+    // Work done solving one game. Empty unless instrumented
+    struct GameStats {
+        std::map<Phase, PhaseStats> phases;
+
+        CountingStats counting;
+
+        // heap allocations made by the thread solving the game
+        unsigned long long allocations = 0;
+
+        /**
+         * Format the stats as a single line JSON object.
+         * 
+         * @return JSON object of the stats, without a newline
+         */
+        std::string json() const;
+    };
+
+    /**
+     * Get the number of heap allocations made by the calling thread so
+     * far. Always 0 unless instrumented.
+     * 
+     * @return number of allocations
+     */
+    unsigned long long allocations();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <solver/enumerator.hpp>
+#include <set>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Expected outcome of revealing a covered cell.
+     */
+    struct Score {
+        Node* node;
+
+        // probability that the cell is safe
+        double survival;
+
+        // probability that revealing the cell, given it is safe, makes
+        // another cell safe or a mine by the local hint rules
+        double progress;
+
+        // How much riskier a guess sure to make progress may be than one
+        // that can't, relative to its survival. Ranking by survival times
+        // progress instead guesses too riskily and loses games
+        static constexpr double progress_weight = 0.05;
+
+        /**
+         * Get the value of revealing the cell, which candidates are ranked
+         * by: its chance of surviving, weighted up by its chance of making
+         * progress.
+         * 
+         * @return survival * (1 + progress_weight * progress)
+         */
+        double value() const;
+    };
+
+    /**
+     * Guess policy which looks one reveal ahead.
+     * 
+     * The least probable mines are taken as candidates, then boards
+     * consistent with every hint and the number of mines left are drawn by
+     * a MarkovChainSampler, with the interior cells next to the candidates
+     * drawn from the mines each board leaves the interior. Each board gives
+     * every candidate the hint it would reveal, and whether that hint lets
+     * the pairwise hint rules of the Basic and Advanced solvers make
+     * progress. Candidates are ranked by their chance of surviving, weighted
+     * up by their chance of making progress, and candidates as good by their
+     * chance of surviving.
+     * 
+     * Boards are drawn on the calling thread and rollouts are seeded by
+     * their index, so the scores for a seed are the same however many
+     * threads they are run on.
+     */
+    class LookaheadPolicy {
+        // Sweeps each chain of the board sampler burns in for
+        static constexpr unsigned long burn_in = 50;
+
+        unsigned int _rollouts;
+        unsigned int _candidates;
+        unsigned long _seed;
+        std::shared_ptr<ThreadPool> _pool;
+
+    public:
+        /**
+         * Create a policy with the given rollout budget.
+         * 
+         * @param rollouts number of boards to sample per guess
+         * @param candidates number of least probable mines to score
+         * @param seed seed of the sampled boards
+         * @param pool thread pool to run rollouts on, or nullptr to run them
+         *      on the calling thread
+         */
+        LookaheadPolicy(unsigned int rollouts = 256, unsigned int candidates = 8, unsigned long seed = 0, std::shared_ptr<ThreadPool> pool = nullptr);
+
+        /**
+         * Score the covered cells least likely to be mines. Mine
+         * probabilities must already be set on `covered`.
+         * 
+         * @param components components of the hint edge
+         * @param covered all covered cells
+         * @param mines_left number of mines not yet flagged
+         * 
+         * @return scores of the candidates, best first
+         */
+        std::vector<Score> score(const std::vector<Component>& components, const std::set<Node*>& covered, int mines_left) const;
+    };
+}
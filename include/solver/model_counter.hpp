@@ -0,0 +1,60 @@
+#pragma once
+
+#include <solver/component_cache.hpp>
+#include <optional>
+#include <utility>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Exact model counter for the "exactly k of these cells" constraints of
+     * frontier Components, in the style of #SAT solvers.
+     * 
+     * Counting branches on the cell in the most constraints, then propagates
+     * the constraints that become forced: all of a constraint's cells are
+     * safe once it has its mines, and all are mines once they are all
+     * needed. The constraints left are split into independent components,
+     * which are counted separately and multiplied together. Every component
+     * counted is cached by its constraint structure, so a shape met again
+     * under another branch, including one proven to have no models, is not
+     * counted twice.
+     */
+    class ModelCounter {
+        ComponentCache _cache;
+        unsigned long long _decisions = 0;
+
+        Counts count_residual(const std::vector<unsigned int>& cells, const std::vector<Constraint>& constraints);
+
+        Counts propagate_and_count(const std::vector<unsigned int>& cells, const std::vector<Constraint>& constraints, std::optional<std::pair<unsigned int, unsigned int>> assignment);
+
+    public:
+        /**
+         * Create a model counter.
+         * 
+         * @param cache_capacity number of components to remember
+         */
+        ModelCounter(std::size_t cache_capacity = 1 << 16);
+
+        /**
+         * Count the models of `component` by the number of mines used.
+         * 
+         * @param component component to count the models of
+         * 
+         * @return solution counts of `component`
+         */
+        Counts count(const Component& component);
+
+        /**
+         * Get the cache of components counted so far.
+         * 
+         * @return component cache of the counter
+         */
+        const ComponentCache& cache() const;
+
+        /**
+         * Get the number of cells branched on by all calls to `count`.
+         * 
+         * @return number of decisions
+         */
+        unsigned long long decisions() const;
+    };
+}
@@ -1,10 +1,10 @@
+#pragma once
+
 #include <minesweeper.hpp>
-#include <boost/rational.hpp>
 #include <set>
 
 namespace minesweeper::solver {
     using minesweeper::Tile;
-    using Fraction = boost::rational<int>;
 
     /**
      * A node representing the Solver's knowledge of an associated tile
@@ -14,7 +14,7 @@ namespace minesweeper::solver {
         const std::pair<unsigned int, unsigned int> _coord;
         Tile _value = Tile::Covered;
         std::set<Node*> _adjacent{};
-        Fraction _mine_probability{};
+        double _mine_probability = 0.0;
         unsigned short _adjacent_mines_left = 0;
 
     public:
@@ -96,18 +96,18 @@ namespace minesweeper::solver {
         /**
          * Get the probability of this Node being a mine.
          * 
-         * @return rational number in [0, 1] representing a probability
+         * @return number in [0, 1] representing a probability
          */
-        Fraction mine_probability() const;
+        double mine_probability() const;
 
         /**
          * Set the probability of this Node being a mine.
          * 
-         * @param mp a rational number in [0, 1] representing a probability
+         * @param mp a number in [0, 1] representing a probability
          * 
          * @throws std::invalid_argument if `mp` is outside of the range [0, 1]
          */
-        void set_mine_probability(Fraction mp);
+        void set_mine_probability(double mp);
 
         /**
          * Get the number of mines adjacent to this node that haven't been
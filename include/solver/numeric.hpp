@@ -0,0 +1,155 @@
+#pragma once
+
+#include <boost/rational.hpp>
+#include <vector>
+
+namespace minesweeper::solver::numeric {
+    /**
+     * Non-negative number stored as its natural logarithm, so that huge
+     * solution counts and tiny weights neither overflow nor underflow.
+     * 
+     * Subtraction saturates at 0, as negative numbers can't be stored.
+     */
+    class LogDouble {
+        double _log;
+
+    public:
+        /**
+         * Create a LogDouble equal to `value`.
+         * 
+         * @param value non-negative value
+         */
+        LogDouble(double value = 0.0);
+
+        /**
+         * Create a LogDouble from its natural logarithm.
+         * 
+         * @param log natural logarithm of the value
+         * 
+         * @return LogDouble equal to e^`log`
+         */
+        static LogDouble from_log(double log);
+
+        /**
+         * Get the natural logarithm of the value.
+         * 
+         * @return log of the value, -infinity for 0
+         */
+        double log() const;
+
+        /**
+         * Get the value as a double, which may overflow to infinity or
+         * underflow to 0.
+         * 
+         * @return value of this number
+         */
+        double value() const;
+
+        LogDouble& operator+=(const LogDouble& other);
+        LogDouble& operator-=(const LogDouble& other);
+        LogDouble& operator*=(const LogDouble& other);
+        LogDouble& operator/=(const LogDouble& other);
+
+        friend LogDouble operator+(LogDouble left, const LogDouble& right) { return left += right; }
+        friend LogDouble operator-(LogDouble left, const LogDouble& right) { return left -= right; }
+        friend LogDouble operator*(LogDouble left, const LogDouble& right) { return left *= right; }
+        friend LogDouble operator/(LogDouble left, const LogDouble& right) { return left /= right; }
+
+        friend bool operator==(const LogDouble& left, const LogDouble& right) { return left._log == right._log; }
+        friend auto operator<=>(const LogDouble& left, const LogDouble& right) { return left._log <=> right._log; }
+    };
+
+    // Number policies for mine probabilities. Each policy names the type
+    // probabilities are calculated in, and how solution counts, which are
+    // whole numbers stored as doubles, and binomial weights become that
+    // type.
+
+    /**
+     * Plain floating point. Fast, and exact enough for guessing.
+     */
+    struct Float {
+        using value_type = double;
+
+        /**
+         * Convert a solution count.
+         * 
+         * @param count solution count
+         * 
+         * @return `count` as a value_type
+         */
+        static value_type count(double count);
+
+        /**
+         * Get C(n, k) for each k, all scaled by the same positive factor so
+         * that the largest doesn't overflow.
+         * 
+         * @param n number of cells to choose from
+         * @param ks numbers of cells to choose, each in [0, n]
+         * 
+         * @return scaled binomial coefficient of each k
+         */
+        static std::vector<value_type> binomials(unsigned int n, const std::vector<unsigned int>& ks);
+
+        /**
+         * Convert a probability calculated in floating point, e.g. by
+         * sampling.
+         * 
+         * @param probability probability in [0, 1]
+         * 
+         * @return `probability` as a value_type
+         */
+        static value_type from_double(double probability);
+
+        /**
+         * Convert a value to floating point.
+         * 
+         * @param value value to convert
+         * 
+         * @return `value` as a double
+         */
+        static double to_double(const value_type& value);
+    };
+
+    /**
+     * Floating point in log space, for boards whose counts overflow a
+     * double. See Float for the policy's functions.
+     */
+    struct LogSpace {
+        using value_type = LogDouble;
+
+        static value_type count(double count);
+        static std::vector<value_type> binomials(unsigned int n, const std::vector<unsigned int>& ks);
+        static value_type from_double(double probability);
+        static double to_double(const value_type& value);
+    };
+
+    /**
+     * Exact rationals, for checking the other policies on small boards.
+     * Counts and binomials must fit in a long long, and arithmetic on them
+     * is not checked for overflow. See Float for the policy's functions.
+     */
+    struct Exact {
+        using value_type = boost::rational<long long>;
+
+        /**
+         * Convert a solution count. Counts which aren't whole numbers, e.g.
+         * estimates, are approximated.
+         * 
+         * @throws std::overflow_error if `count` doesn't fit in a long long
+         */
+        static value_type count(double count);
+
+        /**
+         * Get C(n, k) for each k, unscaled.
+         */
+        static std::vector<value_type> binomials(unsigned int n, const std::vector<unsigned int>& ks);
+
+        /**
+         * Convert a probability to the closest rational with a bounded
+         * denominator.
+         */
+        static value_type from_double(double probability);
+
+        static double to_double(const value_type& value);
+    };
+}
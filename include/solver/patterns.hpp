@@ -0,0 +1,132 @@
+#pragma once
+
+#include <solver/component_cache.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Read only database of the solution counts of small frontier
+     * Components, stored in a file which is memory mapped on first use.
+     * Processes using the same file share its pages.
+     * 
+     * Components are stored in a canonical form which is the same under the
+     * 8 symmetries of the board (rotations and reflections), so one entry
+     * covers every orientation of a pattern.
+     * 
+     * The file starts with a header of the magic bytes and the number of
+     * patterns, followed by an index of (key hash, record offset) pairs
+     * sorted by hash. Each record holds the key length, the cell count, the
+     * key, then the pattern's Counts.
+     */
+    class PatternDatabase {
+    public:
+        /**
+         * Canonical form of a component.
+         */
+        struct Canonical {
+            // constraint structure of the component with its cells numbered
+            // in canonical order, as encoded by ComponentCache::key
+            ComponentCache::Key key;
+
+            // cells[i] is the index in the component of canonical cell i
+            std::vector<unsigned int> cells;
+        };
+
+    private:
+        struct IndexEntry {
+            std::uint64_t hash;
+            std::uint64_t offset;
+        };
+
+        std::string _path;
+        mutable std::once_flag _loaded;
+        mutable const unsigned char* _data = nullptr;
+        mutable std::size_t _size = 0;
+
+        void load() const;
+
+        const char* check() const;
+
+        const IndexEntry* index() const;
+
+        std::uint64_t pattern_count() const;
+
+    public:
+        // magic bytes at the start of a pattern database file
+        static constexpr char magic[8] = { 'M', 'S', 'P', 'A', 'T', 'D', 'B', '1' };
+
+        /**
+         * Create a database backed by the file at `path`. The file isn't
+         * opened until the first lookup, and a missing file is treated as an
+         * empty database.
+         * 
+         * @param path path of the database file
+         */
+        PatternDatabase(std::string path);
+
+        PatternDatabase(const PatternDatabase&) = delete;
+        PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+        ~PatternDatabase();
+
+        /**
+         * Get the canonical form of a component: the smallest key over the
+         * numberings of its cells in coordinate order under each of the 8
+         * board symmetries.
+         * 
+         * @param component component to canonicalise
+         * 
+         * @return canonical form of `component`
+         */
+        static Canonical canonical(const Component& component);
+
+        /**
+         * Renumber the cells of a component in canonical order.
+         * 
+         * @param component component to renumber
+         * @param canonical canonical form of `component`
+         * 
+         * @return component with cell i being canonical cell i
+         */
+        static Component reorder(const Component& component, const Canonical& canonical);
+
+        /**
+         * Look up the solution counts of a component.
+         * 
+         * @param component component to look up
+         * 
+         * @return counts of `component` in its own cell order, or no value if
+         *      it isn't in the database
+         * 
+         * @throws std::runtime_error if the file isn't a pattern database, or
+         *      its index or records run past its end
+         */
+        std::optional<Counts> find(const Component& component) const;
+
+        /**
+         * Get the number of patterns in the database.
+         * 
+         * @return number of patterns
+         * 
+         * @throws std::runtime_error if the file isn't a pattern database, or
+         *      its index or records run past its end
+         */
+        std::size_t size() const;
+
+        /**
+         * Write a pattern database file. The file is written beside `path`
+         * then renamed over it, so processes which have the old file mapped
+         * keep reading the old file.
+         * 
+         * @param path path of the file to write
+         * @param patterns canonical keys of the patterns, with their counts in
+         *      canonical cell order
+         * 
+         * @throws std::runtime_error if the file can't be written
+         */
+        static void write(const std::string& path, const std::vector<std::pair<ComponentCache::Key, Counts>>& patterns);
+    };
+}
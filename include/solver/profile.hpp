@@ -0,0 +1,44 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Exact solution counter for long, thin frontier Components.
+     * 
+     * Cells are ordered along the component so that each constraint spans
+     * a short stretch of the order, then swept one at a time. The state
+     * between two cells (the profile) is the number of mines given so far to
+     * each constraint that has cells on both sides, so the work grows with
+     * the length of the component rather than exponentially, as long as few
+     * constraints are open at once. A forward and a backward sweep give the
+     * counts of every cell.
+     */
+    class ProfileCounter {
+    public:
+        // Largest number of constraints that may be open at once
+        static constexpr unsigned int max_width = 16;
+
+        /**
+         * Get the largest number of constraints open at once when sweeping
+         * `component`'s cells.
+         * 
+         * @param component component to measure
+         * 
+         * @return width of the component's profile
+         */
+        static unsigned int width(const Component& component);
+
+        /**
+         * Count the solutions of `component` by the number of mines used.
+         * 
+         * @param component component to count the solutions of
+         * 
+         * @return solution counts of `component`
+         * 
+         * @throws std::invalid_argument if the width of the component is
+         *      more than `max_width`
+         */
+        Counts count(const Component& component);
+    };
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <minesweeper.hpp>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace minesweeper::solver {
+    /**
+     * What the terminal shows of a game: the solver's mode, one glyph per
+     * tile and the selected tile.
+     */
+    class Frame {
+        std::string _mode;
+        unsigned int _width = 0, _height = 0;
+        std::vector<char> _glyphs;
+        int _selected = -1;
+
+    public:
+        Frame() = default;
+
+        /**
+         * Create a frame of covered tiles.
+         * 
+         * @param width width of the minefield
+         * @param height height of the minefield
+         */
+        Frame(unsigned int width, unsigned int height);
+
+        unsigned int width() const;
+
+        unsigned int height() const;
+
+        const std::string& mode() const;
+
+        void set_mode(const char* mode);
+
+        /**
+         * Get the glyph shown for the tile at (x,y).
+         * 
+         * @param x x-coordinate of the tile
+         * @param y y-coordinate of the tile
+         * 
+         * @return glyph of the tile
+         */
+        char glyph(unsigned int x, unsigned int y) const;
+
+        /**
+         * Set the value shown for the tile at (x,y).
+         * 
+         * @param x x-coordinate of the tile
+         * @param y y-coordinate of the tile
+         * @param value known value of the tile
+         */
+        void set(unsigned int x, unsigned int y, Tile value);
+
+        /**
+         * Check whether the tile at (x,y) is selected.
+         * 
+         * @return true if the tile is highlighted
+         */
+        bool selected(unsigned int x, unsigned int y) const;
+
+        void set_selected(unsigned int x, unsigned int y);
+    };
+
+    /**
+     * Draws frames to a terminal, rewriting only the tiles which changed
+     * since the last frame drawn.
+     * 
+     * Each frame is built into one buffer of ANSI cursor movements and
+     * glyphs, which is written at once. Frames requested faster than the
+     * frame rate are held back, and the latest is drawn by the next frame
+     * or `flush`, so a fast solve doesn't flood a slow terminal.
+     */
+    class FrameRenderer {
+        using Clock = std::chrono::steady_clock;
+
+        std::ostream* _out;
+        Clock::duration _frame_interval;
+        std::optional<Clock::time_point> _last_draw;
+        Frame _shown, _pending;
+        bool _has_pending = false;
+        std::string _buffer;
+
+        void draw(const Frame& frame);
+        void build(const Frame& frame, std::string& out) const;
+
+    public:
+        /**
+         * Create a renderer which draws at most one frame per interval.
+         * 
+         * @param out terminal to draw to
+         * @param frame_interval least time between frames, or 0 to draw
+         *      every frame
+         */
+        FrameRenderer(std::ostream& out = std::cout, std::chrono::milliseconds frame_interval = std::chrono::milliseconds(16));
+
+        /**
+         * Draw a frame, unless the last was drawn less than the frame
+         * interval ago, in which case it is kept until the next draw.
+         * 
+         * @param frame frame to draw
+         * 
+         * @return true if the frame was drawn
+         */
+        bool render(const Frame& frame);
+
+        /**
+         * Draw the frame held back by the frame rate, if any.
+         */
+        void flush();
+
+        /**
+         * Build the output which changes the terminal from the last frame
+         * drawn to `frame`. The whole screen is redrawn for the first frame
+         * or a change of size.
+         * 
+         * @param frame frame to show
+         * 
+         * @return escape sequences and glyphs to write to the terminal
+         */
+        std::string diff(const Frame& frame) const;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace minesweeper::solver {
+    /**
+     * A fixed size queue between one producer thread and one consumer
+     * thread, which takes no locks.
+     * 
+     * The producer only writes the tail and the consumer only writes the
+     * head, each on its own cache line, so neither waits for the other.
+     * 
+     * @tparam T type of the values queued, which should be cheap to copy
+     * @tparam Capacity number of values the queue holds, a power of two
+     */
+    template <typename T, std::size_t Capacity>
+    class RingBuffer {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        static constexpr std::size_t cache_line = 64;
+
+        std::array<T, Capacity> _slots {};
+        alignas(cache_line) std::atomic<std::size_t> _head = 0;
+        alignas(cache_line) std::atomic<std::size_t> _tail = 0;
+
+    public:
+        /**
+         * Queue a value, unless the queue is full. Only called by the
+         * producer.
+         * 
+         * @param value value to queue
+         * 
+         * @return true if the value was queued
+         */
+        bool try_push(const T& value) {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+            _slots[tail & (Capacity - 1)] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Take the oldest value from the queue. Only called by the
+         * consumer.
+         * 
+         * @return the oldest value, or nothing if the queue is empty
+         */
+        std::optional<T> try_pop() {
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head == _tail.load(std::memory_order_acquire)) {
+                return std::nullopt;
+            }
+            auto value = _slots[head & (Capacity - 1)];
+            _head.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+        /**
+         * Get the number of values queued. Exact when called by the
+         * consumer or producer with the other idle, a snapshot otherwise.
+         * 
+         * @return number of values queued
+         */
+        std::size_t size() const {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+
+        static constexpr std::size_t capacity() {
+            return Capacity;
+        }
+    };
+}
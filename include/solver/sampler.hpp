@@ -0,0 +1,109 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Convergence diagnostics of the last run of a MarkovChainSampler.
+     */
+    struct Diagnostics {
+        // number of configurations sampled by each chain after burn in
+        unsigned long samples = 0;
+
+        // largest Gelman-Rubin potential scale reduction factor of any
+        // cell's probability, close to 1 once the chains have mixed
+        double max_r_hat = 0;
+
+        /**
+         * Check whether the chains agree closely enough to trust the
+         * sampled probabilities.
+         * 
+         * @return true if every R-hat is below 1.1
+         */
+        bool converged() const;
+    };
+
+    /**
+     * Mine configuration of the frontier drawn by a MarkovChainSampler.
+     */
+    struct Configuration {
+        // whether each cell of the frontier is a mine, component by
+        // component
+        std::vector<bool> cells;
+
+        // number of mines the configuration leaves the interior
+        unsigned int interior_mines;
+    };
+
+    /**
+     * Markov chain Monte Carlo sampler of the mine configurations of the
+     * frontier, for frontiers too large to count exactly.
+     * 
+     * Each step picks a block of cells sharing a constraint, plus the cells
+     * of one neighbouring constraint, and redraws the block from every
+     * assignment which keeps all constraints satisfied. Assignments are
+     * weighted by the number of ways the remaining mines can be placed in
+     * the interior, so the chain keeps to the global mine count. Several
+     * chains are run from random starting configurations to diagnose
+     * convergence.
+     */
+    class MarkovChainSampler {
+        unsigned long _seed;
+        unsigned long _samples;
+        unsigned int _chains;
+        Diagnostics _diagnostics;
+
+    public:
+        /**
+         * Create a sampler.
+         * 
+         * @param seed seed of the chains' RNGs. Samplers with the same seed
+         *      and budget give the same probabilities
+         * @param samples number of sweeps each chain samples after burning
+         *      in for half as many. A sweep makes one step per constraint
+         * @param chains number of chains to run, at least 2
+         * 
+         * @throws std::invalid_argument if there are fewer than 2 chains or
+         *      samples
+         */
+        MarkovChainSampler(unsigned long seed = 0, unsigned long samples = 1000, unsigned int chains = 4);
+
+        /**
+         * Estimate the mine probabilities of the frontier and interior.
+         * 
+         * @param components components of the frontier
+         * @param interior_cells number of covered cells not on the frontier
+         * @param mines_left number of mines not yet flagged
+         * 
+         * @return estimated mine probabilities
+         * 
+         * @throws std::invalid_argument if a component has no solution
+         */
+        Probabilities sample(const std::vector<Component>& components, unsigned int interior_cells, unsigned int mines_left);
+
+        /**
+         * Draw mine configurations of the frontier, keeping to the global
+         * mine count like `sample`. Each chain burns in for half the sample
+         * budget, then gives its share of the configurations one sweep
+         * apart, so configurations of the same chain are correlated.
+         * 
+         * @param components components of the frontier
+         * @param interior_cells number of covered cells not on the frontier
+         * @param mines_left number of mines not yet flagged
+         * @param count number of configurations to draw
+         * 
+         * @return up to `count` configurations, fewer if some sweeps left
+         *      the interior an impossible number of mines
+         * 
+         * @throws std::invalid_argument if a component has no solution
+         */
+        std::vector<Configuration> configurations(const std::vector<Component>& components, unsigned int interior_cells, unsigned int mines_left, unsigned long count);
+
+        /**
+         * Get the convergence diagnostics of the last call to `sample`.
+         * 
+         * @return convergence diagnostics
+         */
+        const Diagnostics& diagnostics() const;
+    };
+}
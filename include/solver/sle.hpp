@@ -1,7 +1,10 @@
+#pragma once
+
 #include <solver/node.hpp>
 #include <boost/rational.hpp>
 #include <unordered_map>
 #include <map>
+#include <cstdint>
 
 namespace minesweeper::solver::sle {
     // Integer based rational
@@ -15,7 +18,145 @@ namespace minesweeper::solver::sle {
 
     // pair representing sum(Coefficients) = Fraction. e.g. 3/2x + -2y = 5/3
     using Equation = std::pair<Coefficients, Fraction>;
+
+    /**
+     * A precomputed plan for evaluating a system of linear equations.
+     * 
+     * Variables are stored in dense slots. The first `input_count()` slots
+     * hold the independent variables which are assigned by the caller, and
+     * the remaining slots are filled in by evaluating the plan's steps in
+     * order. Each step solves a single dependent variable from the slots
+     * which have already been assigned.
+     */
+    class EvaluationPlan {
+        // term of an equation, made of a variable slot and its coefficient
+        struct Term {
+            unsigned int slot;
+            Fraction coefficient;
+        };
+
+        // solves `target` = (total - sum(terms)) / pivot
+        struct Step {
+            unsigned int target;
+            Fraction pivot;
+            Fraction total;
+            std::size_t terms_begin, terms_end;
+        };
+
+        std::vector<Node*> _variables;
+        unsigned int _input_count = 0;
+        std::vector<Term> _terms;
+        std::vector<Step> _steps;
+
+        friend class SystemOfLinearEquations;
+        friend class BatchEvaluator;
+
+    public:
+        /**
+         * Get the variable held in each slot of the plan.
+         * 
+         * @return list of variables, indexed by slot
+         */
+        const std::vector<Node*>& variables() const;
+
+        /**
+         * Get the number of independent variables, which occupy the first
+         * slots of the plan.
+         * 
+         * @return number of independent variables
+         */
+        unsigned int input_count() const;
+
+        /**
+         * Evaluate the plan, filling in the values of all dependent variables.
+         * 
+         * @param values value of each variable slot. Must have one entry per
+         *      variable, with the independent variables already assigned
+         * 
+         * @throws std::invalid_argument thrown if `values` does not have
+         *      one entry per variable
+         */
+        void evaluate(std::vector<Fraction>& values) const;
+    };
     
+    /**
+     * Bit-sliced evaluator of an EvaluationPlan for 0/1 valued variables.
+     * 
+     * Evaluates 64 assignments of the independent variables at once, one
+     * per bit ("lane") of a machine word. The first `lane_inputs()` inputs
+     * take every combination across the lanes of a batch, while the
+     * remaining inputs are fixed for the whole batch. An assignment is valid
+     * if every dependent variable evaluates to exactly 0 or 1.
+     */
+    class BatchEvaluator {
+        // value of a dependent variable's partial sum, and the lanes it occurs in
+        using LaneValues = std::vector<std::pair<std::int64_t, std::uint64_t>>;
+
+        /* Dependent variable d is solved as
+           (constant + sum(lane_sum) + sum(coefficient[i] * batch_input[i])) / denominator
+           where lane_sum is the lane dependent sum of the first inputs */
+        struct Dependent {
+            unsigned int slot;
+            std::int64_t constant, denominator;
+            std::vector<std::int64_t> coefficients;
+            LaneValues lane_values;
+        };
+
+        unsigned int _variable_count;
+        unsigned int _input_count;
+        unsigned int _lane_inputs;
+        std::uint64_t _lane_mask;
+        std::vector<Dependent> _dependents;
+
+        static std::uint64_t lanes_with(const LaneValues& lane_values, std::int64_t value);
+
+    public:
+        // Number of assignments evaluated per batch
+        static constexpr unsigned int lanes = 64;
+
+        /**
+         * Create a bit-sliced evaluator for the given plan.
+         * 
+         * @param plan plan to evaluate
+         * 
+         * @throws std::overflow_error thrown if the coefficients of the plan
+         *      cannot be represented as 64-bit integers
+         */
+        BatchEvaluator(const EvaluationPlan& plan);
+
+        /**
+         * Get the number of inputs which vary across the lanes of a batch.
+         * These are the first `lane_inputs()` slots of the plan.
+         * 
+         * @return number of inputs assigned per lane
+         */
+        unsigned int lane_inputs() const;
+
+        /**
+         * Get the number of inputs which are fixed for a whole batch. These
+         * are the slots of the plan after the lane inputs.
+         * 
+         * @return number of inputs assigned per batch
+         */
+        unsigned int batch_inputs() const;
+
+        /**
+         * Evaluate every combination of the lane inputs, with the batch inputs
+         * fixed to the given values.
+         * 
+         * @param batch_values 0/1 value of each batch input
+         * @param mine_counts incremented, per variable slot, by the number of
+         *      valid assignments in which the variable is 1. Must have one
+         *      entry per variable slot
+         * 
+         * @return number of valid assignments in the batch
+         * 
+         * @throws std::invalid_argument thrown if `batch_values` or
+         *      `mine_counts` have the wrong size
+         */
+        std::uint64_t evaluate(const std::vector<std::uint8_t>& batch_values, std::vector<std::uint64_t>& mine_counts) const;
+    };
+
     /**
      * A system of linear equations.
      * 
@@ -98,9 +239,111 @@ namespace minesweeper::solver::sle {
          */
         void evaluate(Assignments& assignments) const;
 
+        /**
+         * Compile the system of linear equations into an EvaluationPlan,
+         * treating the given variables as the inputs of the plan.
+         * 
+         * The order in which dependent variables are solved is the same as
+         * `evaluate`, but is computed once so that each evaluation of the plan
+         * is a straight pass over the equations.
+         * 
+         * @param inputs variables which will be assigned before evaluation,
+         *      usually the independent variables of the system
+         * 
+         * @return plan for evaluating the system
+         * 
+         * @throws std::invalid_argument thrown if `inputs` are not enough to
+         *      solve the system of linear equations
+         */
+        EvaluationPlan compile(const std::set<Node*>& inputs) const;
+
         /**
          * Print the equations in the system of linear equations.
          */
         void print() const;
     };
+
+    /**
+     * A system of linear equations which is kept in row echelon form while
+     * equations are added, updated and removed.
+     * 
+     * Each equation is keyed by a Node, e.g. the hint tile it was built from.
+     * Equations are grouped into components which share no variables, and a
+     * change to an equation only re-eliminates the components it touches.
+     */
+    class IncrementalSystemOfLinearEquations {
+        // equations connected through shared variables, in row echelon form
+        struct Component {
+            std::set<Node*> keys;
+            std::set<Node*> variables;
+            std::vector<Equation> echelon;
+        };
+
+        std::map<Node*, Equation> _rows;
+        std::map<unsigned int, Component> _components;
+        unsigned int _next_component = 0;
+        std::unordered_map<Node*, unsigned int> _row_component;
+        std::unordered_map<Node*, unsigned int> _variable_component;
+        std::set<unsigned int> _dirty_components;
+        std::set<Node*> _pending_keys;
+
+        void mark_dirty(Node* key, const Coefficients& coefficients);
+        void update();
+
+    public:
+        /**
+         * Add the equation for `key`, or replace it if one already exists.
+         * 
+         * Setting an equation identical to the existing one does nothing.
+         * 
+         * @param key Node the equation belongs to
+         * @param coefficients map of variables to their coefficients
+         * @param total value that the variables and coefficients sum to
+         */
+        void set_equation(Node* key, const Coefficients& coefficients, const Fraction& total);
+
+        /**
+         * Remove the equation for `key`, if there is one.
+         * 
+         * @param key Node the equation belongs to
+         */
+        void remove_equation(Node* key);
+
+        /**
+         * Get the keys of all equations in the system.
+         * 
+         * @return set of keys
+         */
+        std::set<Node*> keys() const;
+
+        /**
+         * Get the number of groups of equations which share no variables
+         * with each other.
+         * 
+         * @return number of components
+         */
+        unsigned int component_count();
+
+        /**
+         * Get all equations of the system in row echelon form.
+         * 
+         * @return list of Equations, grouped by component
+         */
+        std::vector<Equation> equations();
+
+        /**
+         * Get all independent variables of the system.
+         * 
+         * @return Set of all independent variables
+         */
+        std::set<Node*> independent_variables();
+
+        /**
+         * Get the system in row echelon form as a SystemOfLinearEquations,
+         * e.g. to compile an EvaluationPlan from it.
+         * 
+         * @return system of linear equations in row echelon form
+         */
+        SystemOfLinearEquations system();
+    };
 }
\ No newline at end of file
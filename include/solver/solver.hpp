@@ -1,11 +1,42 @@
+#pragma once
+
 #include <solver/sle.hpp>
+#include <solver/enumerator.hpp>
+#include <solver/sampler.hpp>
+#include <solver/profile.hpp>
+#include <solver/model_counter.hpp>
+#include <solver/component_tracker.hpp>
+#include <solver/lookahead.hpp>
+#include <solver/endgame.hpp>
+#include <solver/numeric.hpp>
+#include <solver/instrumentation.hpp>
+#include <solver/renderer.hpp>
+#include <functional>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
 
 namespace minesweeper::solver {
     using minesweeper::Minesweeper;
 
     class SolverState {
+        // Nodes derived from the node values, kept up to date by `update`.
+        // Copies of a state share its nodes, so they share these too
+        struct Tracked {
+            std::set<Node*> covered;
+            std::set<Node*> hint_edge;
+
+            // every node whose value changed since the state was created,
+            // in order
+            std::vector<Node*> changes;
+        };
+
         std::vector<std::vector<Node*>> state;
         Node* _selected;
+        std::shared_ptr<Tracked> tracked;
+
+        void track(Node* node);
 
     public:
         /**
@@ -35,7 +66,7 @@ namespace minesweeper::solver {
          * 
          * @return set of all Nodes in the state with value Tile::Covered
          */
-        std::set<Node*> covered();
+        const std::set<Node*>& covered() const;
 
         /**
          * Get all hint nodes that are adjacent to a covered node.
@@ -44,19 +75,30 @@ namespace minesweeper::solver {
          * 
          * @return set of all hint Nodes that are adjacent to a covered node
          */
-        std::set<Node*> hint_edge();
+        const std::set<Node*>& hint_edge() const;
 
         /**
          * Get all covered nodes that are adjacent to a hint node.
          * 
          * @return set of all covered nodes that are adjacent to a hint node
          */
-        std::set<Node*> covered_edge();
+        std::set<Node*> covered_edge() const;
+
+        /**
+         * Get every node whose value was changed by `update`, in the order
+         * they changed. Shared by copies of the state, so that its identity
+         * tells states apart.
+         * 
+         * @return log of changed nodes
+         */
+        std::shared_ptr<const std::vector<Node*>> changes() const;
 
         /**
          * Update the value of `node` based on its value in `minefield`.
          * 
          * If the value of `node` is 0, all adjacent nodes are also updated.
+         * The covered nodes and hint edge are updated around the nodes which
+         * changed, so an update costs as much as the tiles it reveals.
          * 
          * @param node pointer to the node to update
          * @param minefield known values of tiles in the Minesweeper Minefield
@@ -91,15 +133,85 @@ namespace minesweeper::solver {
         Node* get_node(const unsigned int x, const unsigned int y);
     };
 
+    /**
+     * Logger which draws the state to a terminal after each move, pausing
+     * for an animation delay.
+     */
     class StateLogger {
         const char* _mode = "";
         unsigned int animation_delay;
+        Frame frame;
+        FrameRenderer renderer;
     public:
-        StateLogger(unsigned int animation_delay_ms);
+        /**
+         * Create a logger which draws to `out`.
+         * 
+         * @param animation_delay_ms time to pause after each move
+         * @param out terminal to draw to
+         */
+        StateLogger(unsigned int animation_delay_ms, std::ostream& out = std::cout);
 
         void set_mode(const char* mode);
 
-        void log(SolverState state);
+        void log(SolverState& state);
+
+        /**
+         * Draw the last state logged, if the frame rate held it back.
+         */
+        void flush();
+    };
+
+    /**
+     * Logger which draws the state to a terminal on its own thread, so
+     * that drawing and the animation delay never slow the solver.
+     * 
+     * Each move is sent as the tiles which changed through a lock-free
+     * queue, found from the state's log of changed nodes. When the queue is
+     * full, changes wait in the solver until a later move, which compares
+     * the whole board to find them, and when the drawing thread falls
+     * behind it skips drawing moves until it catches up. Copies share the
+     * drawing thread.
+     */
+    class AsyncStateLogger {
+        struct Shared;
+        std::shared_ptr<Shared> shared;
+    public:
+        /**
+         * Create a logger which draws to `out` from a new thread.
+         * 
+         * @param animation_delay_ms time to pause after drawing each move
+         * @param out terminal to draw to
+         */
+        AsyncStateLogger(unsigned int animation_delay_ms, std::ostream& out = std::cout);
+
+        void set_mode(const char* mode);
+
+        /**
+         * Send the tiles changed since the last call to the drawing thread,
+         * without waiting for it.
+         * 
+         * @param state state after a move
+         */
+        void log(SolverState& state);
+
+        /**
+         * Wait until the drawing thread has caught up and drawn the last
+         * state logged.
+         */
+        void flush();
+    };
+
+    /**
+     * Logger which does nothing, for solving without a terminal. Its calls
+     * compile to nothing, unlike StateLogger's with a delay of 0.
+     */
+    class NullLogger {
+    public:
+        void set_mode(const char*) {}
+
+        void log(const SolverState&) {}
+
+        void flush() {}
     };
 
     class BasicSolver {
@@ -110,29 +222,348 @@ namespace minesweeper::solver {
     };
 
     class AdvancedSolver {
+        // database of patterns whose safe and mine cells are known
+        std::shared_ptr<const frontier::PatternDatabase> patterns;
+
+        std::set<Node*> determined(SolverState& state, bool mine);
+
     public:
+        /**
+         * Consult the given pattern database before the pairwise hint rules.
+         * Cells of a hint edge component which are safe, or a mine, in every
+         * solution of the stored pattern are safe or flaggable.
+         * 
+         * @param patterns pattern database to use, or nullptr for none
+         */
+        void set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns);
+
         std::set<Node*> flaggable(SolverState state);
 
         std::set<Node*> safe(SolverState state);
     };
 
-    class ProbableSolver {
-        void print_probabilities(SolverState state);
+    /**
+     * Solver which guesses by the mine probabilities of the covered nodes,
+     * calculated in the number type of the numeric policy `Numeric`.
+     * 
+     * Copies have their own equations, counts and model counter, so they
+     * can be used on different threads. They share the thread pool, whose
+     * runs take turns, and the component cache, which is locked.
+     * 
+     * Each solver counts components into a cache of its own unless given
+     * another, e.g. ComponentCache::shared() to share one across the
+     * process.
+     */
+    template <typename Numeric>
+    class BasicProbableSolver {
+    public:
+        using Number = typename Numeric::value_type;
+
+        // Method used to count the possible mine placements of the hint edge
+        enum class Engine {
+            // Bit-sliced brute force of the hint edge's linear equations
+            Bruteforce,
+            // Exact backtracking search of each component of the hint edge
+            Backtracking,
+            // Markov chain Monte Carlo sampling of the hint edge's mine
+            // configurations, for hint edges too large to count
+            Sampling,
+            // Exact profile sweep along each component of the hint edge, for
+            // long and thin hint edges
+            Profile,
+            // Exact model counting of each component of the hint edge, for
+            // dense and highly coupled hint edges
+            ModelCounting
+        };
+
+        // Range a mine probability lies in with 95% confidence
+        struct Interval {
+            double low, high;
+        };
 
-        static bool validate_assignments(sle::Assignments assignments);
+    private:
+        Engine engine;
 
-        sle::Assignments bruteforce(sle::SystemOfLinearEquations& sys_eq, const std::set<Node*>& ind_vars);
+        // time calculate_probability may take, or 0 for no limit
+        std::chrono::nanoseconds time_budget { 0 };
+
+        // seed of the estimates of components not counted within the budget
+        unsigned long estimator_seed = 0;
+
+        // confidence intervals of the hint edge's last probabilities
+        std::map<Node*, Interval> intervals;
+
+        // whether no component of the last hint edge had to be estimated
+        bool counted_exactly = true;
+
+        // equations of the hint edge, kept between calls
+        sle::IncrementalSystemOfLinearEquations equations;
+
+        // threads to count and run rollouts on, or nullptr for the calling
+        // thread only
+        std::shared_ptr<ThreadPool> pool;
+
+        frontier::BacktrackingEnumerator enumerator;
+
+        // components of the last hint edge and their exact counts, so that
+        // only the components changed by a move are rebuilt and counted again
+        frontier::ComponentTracker tracker;
+        bool incremental = true;
+
+        // model counter of the ModelCounting engine, whose cache of counted
+        // components is kept between calls
+        frontier::ModelCounter counter;
+
+        // sampler of the Sampling engine, and of the Bruteforce engine when
+        // there are too many independent variables to enumerate
+        frontier::MarkovChainSampler sampler;
+
+        // guess policy of `solve`, or no value to guess the least probable
+        // mine
+        std::optional<frontier::LookaheadPolicy> lookahead;
+
+        // scores of the candidates of the last guess made with lookahead
+        std::vector<frontier::Score> scores;
+
+        // exact solver of `solve` for boards with few covered cells, if
+        // enabled
+        std::optional<frontier::EndgameSolver> endgame;
+
+        // mine probability of each covered node, as of the last call to
+        // calculate_probability
+        std::unordered_map<Node*, Number> probabilities;
+
+        // systems of linear equations brute forced, if instrumented
+        CountingStats counting;
+
+        void print_probabilities(SolverState& state);
+
+        void set_probability(Node* node, const Number& probability);
+
+        void bruteforce_probability(const std::set<Node*>& hint_edge, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        void enumerate_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        void model_count_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        void profile_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        std::vector<std::optional<frontier::Counts>> count_changed(const std::vector<frontier::Component>& components, const std::function<std::vector<std::optional<frontier::Counts>>(const std::vector<frontier::Component>&)>& count);
+
+        void apply_counts(const std::vector<frontier::Component>& components, const std::vector<frontier::Counts>& counts, const std::vector<std::vector<double>>& margins, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        void sample_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left);
+
+        std::optional<std::unordered_map<Node*, Number>> bruteforce(sle::SystemOfLinearEquations& sys_eq, const std::set<Node*>& ind_vars);
 
     public:
-        void calculate_probability(SolverState state, int mines_left);
+        /**
+         * Create a solver using the given engine.
+         * 
+         * @param engine method used to count mine placements
+         * @param threads number of threads to count on. 0 uses the number of
+         *      hardware threads
+         */
+        BasicProbableSolver(Engine engine = Engine::Backtracking, unsigned int threads = 1);
 
-        Node* solve(SolverState state, int mines_left);
+        /**
+         * Replace the cache of component solution counts used by the
+         * backtracking engine.
+         * 
+         * @param cache cache to use, or nullptr to count every component
+         */
+        void set_cache(std::shared_ptr<frontier::ComponentCache> cache);
+
+        /**
+         * Look up components of the hint edge in the given pattern database
+         * before counting them with the backtracking engine.
+         * 
+         * @param patterns pattern database to use, or nullptr for none
+         */
+        void set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns);
+
+        /**
+         * Choose whether the Backtracking, Profile and ModelCounting engines
+         * rebuild and count only the components of the hint edge which
+         * changed since the last call, reusing the counts of the rest. On by
+         * default.
+         * 
+         * @param incremental false to count every component on every call
+         */
+        void set_incremental(bool incremental);
+
+        /**
+         * Choose guesses by looking one reveal ahead: the `candidates` least
+         * probable mines are scored by their chance of surviving and of
+         * letting the Basic and Advanced solvers make progress afterwards,
+         * over `rollouts` sampled boards. More rollouts trade time for
+         * better guesses.
+         * 
+         * @param rollouts number of boards to sample per guess, or 0 to
+         *      guess the least probable mine
+         * @param candidates number of least probable mines to score
+         * @param seed seed of the sampled boards
+         */
+        void set_lookahead(unsigned int rollouts, unsigned int candidates = 8, unsigned long seed = 0);
+
+        /**
+         * Choose guesses by searching the whole game tree once at most
+         * EndgameSolver::max_cells cells are covered, for the move with the
+         * best chance of winning. Boards with too many mine placements to
+         * search are guessed as usual.
+         * 
+         * @param enabled whether to solve endgames exactly
+         */
+        void set_endgame(bool enabled);
+
+        /**
+         * Get the scores of the candidates of the last guess.
+         * 
+         * @return scores of the candidates, best first, or none if the last
+         *      guess was made without lookahead
+         */
+        const std::vector<frontier::Score>& guess_scores() const;
+
+        /**
+         * Get the tracker of the hint edge's components counted so far.
+         * 
+         * @return component tracker of the solver
+         */
+        const frontier::ComponentTracker& component_tracker() const;
+
+        /**
+         * Replace the sampler used by the Sampling engine, and by the
+         * Bruteforce engine when there are too many independent variables to
+         * enumerate, e.g. to change its seed or sample budget.
+         * 
+         * @param sampler sampler to use
+         */
+        void set_sampler(const frontier::MarkovChainSampler& sampler);
+
+        /**
+         * Get the convergence diagnostics of the last sampled probabilities.
+         * 
+         * @return convergence diagnostics of the sampler
+         */
+        const frontier::Diagnostics& sampling_diagnostics() const;
+
+        /**
+         * Limit the time calculate_probability may take. Components of the
+         * hint edge which can't be counted exactly in the first three
+         * quarters of the budget are estimated from random samples in the
+         * rest, and their probabilities given confidence intervals.
+         * Only used by the backtracking engine.
+         * 
+         * @param budget time calculate_probability may take, or 0 for no
+         *      limit
+         * @param seed seed of the estimates, so that calls which estimate
+         *      the same components make the same probes
+         */
+        void set_time_budget(std::chrono::nanoseconds budget, unsigned long seed = 0);
+
+        /**
+         * Get the confidence intervals of the mine probabilities of the hint
+         * edge, as of the last call to calculate_probability. Exactly
+         * counted nodes have an interval of just their probability, and
+         * sampled nodes have none.
+         * 
+         * @return confidence interval of each node on the hint edge
+         */
+        const std::map<Node*, Interval>& confidence() const;
+
+        /**
+         * Check whether every probability of the last call to
+         * calculate_probability was counted exactly.
+         * 
+         * @return true if no probability was estimated
+         */
+        bool exact() const;
+
+        /**
+         * Get the mine probability of a covered node in the policy's number
+         * type, as of the last call to calculate_probability. Nodes also
+         * hold their probability as a double.
+         * 
+         * @param node covered node
+         * 
+         * @return probability that `node` is a mine
+         * 
+         * @throws std::out_of_range if `node` wasn't covered
+         */
+        Number probability(Node* node) const;
+
+        /**
+         * Get the work done counting mine placements by all calls to
+         * calculate_probability. Only nodes visited are counted unless
+         * instrumented.
+         * 
+         * @return counting stats of the solver
+         */
+        CountingStats counting_stats() const;
+
+        void calculate_probability(SolverState& state, int mines_left);
+
+        Node* solve(SolverState& state, int mines_left);
     };
 
-    class MinesweeperSolver {
+    // Floating point solver, for play
+    using ProbableSolver = BasicProbableSolver<numeric::Float>;
+
+    // Log space solver, for boards whose counts overflow a double
+    using LogProbableSolver = BasicProbableSolver<numeric::LogSpace>;
+
+    // Exact rational solver, for checking the others on small boards
+    using ExactProbableSolver = BasicProbableSolver<numeric::Exact>;
+
+    extern template class BasicProbableSolver<numeric::Float>;
+    extern template class BasicProbableSolver<numeric::LogSpace>;
+    extern template class BasicProbableSolver<numeric::Exact>;
+
+    // Outcome of solving a game
+    struct SolveResult {
+        // whether every safe tile was uncovered without hitting a mine
+        bool won = false;
+
+        // number of tiles flagged or uncovered
+        unsigned int moves = 0;
+
+        // number of tiles uncovered which might have been mines
+        unsigned int guesses = 0;
+
+        // number of moves chosen by each stage
+        std::map<Phase, unsigned int> phase_moves;
+
+        // time taken to solve the game
+        std::chrono::nanoseconds elapsed { 0 };
+
+        // time taken to choose and make each move, if recorded
+        std::vector<std::chrono::nanoseconds> move_times;
+
+        // work done by each stage, if instrumented
+        GameStats stats;
+    };
+
+    /**
+     * Solver of a whole game, which logs each move with `Logger`, e.g.
+     * StateLogger or NullLogger.
+     */
+    template <typename Logger>
+    class BasicMinesweeperSolver {
         Minesweeper game;
         SolverState state;
-        StateLogger logger;
+        Logger logger;
+        std::shared_ptr<const frontier::PatternDatabase> patterns;
+        std::shared_ptr<frontier::ComponentCache> cache;
+        SolveResult result;
+        Phase phase = Phase::Opening;
+        frontier::Clock::time_point phase_start;
+        frontier::Clock::time_point last_move;
+        bool record_moves = false;
+        bool finished = false;
+        unsigned int lookahead_rollouts = 0;
+        bool endgame = true;
+
+        void enter(Phase next);
 
         void flag_or_uncover(Node* node, bool flag);
 
@@ -143,8 +574,69 @@ namespace minesweeper::solver {
         void check_game_state(Minesweeper::GameState game_state);
 
     public:
-        MinesweeperSolver(Minesweeper game, StateLogger logger);
+        BasicMinesweeperSolver(Minesweeper game, Logger logger = Logger());
+
+        /**
+         * Consult the given pattern database in the Advanced and Probable
+         * stages.
+         * 
+         * @param patterns pattern database to use, or nullptr for none
+         */
+        void set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns);
+
+        /**
+         * Count components into the given cache in the Probable stage, so
+         * that its counts are kept across games, e.g. one cache per thread
+         * playing games.
+         * 
+         * @param cache cache to use, or nullptr for one of the game's own
+         */
+        void set_cache(std::shared_ptr<frontier::ComponentCache> cache);
+
+        /**
+         * Choose guesses in the Probable stage by looking one reveal ahead
+         * over the given number of sampled boards.
+         * 
+         * @param rollouts number of boards to sample per guess, or 0 to
+         *      guess the least probable mine
+         */
+        void set_lookahead(unsigned int rollouts);
 
-        void solve();
+        /**
+         * Choose whether guesses are searched exactly once few cells are
+         * covered. On by default.
+         * 
+         * @param enabled whether to solve endgames exactly
+         */
+        void set_endgame(bool enabled);
+
+        /**
+         * Choose whether the time taken by each move is recorded in the
+         * result. Off by default.
+         * 
+         * @param enabled whether to record move times
+         */
+        void set_record_moves(bool enabled);
+
+        /**
+         * Play the game until it is won or a mine is uncovered. A game can
+         * only be solved once.
+         * 
+         * @return outcome of the game
+         */
+        SolveResult solve();
     };
+
+    // Solver which draws each move in the terminal
+    using MinesweeperSolver = BasicMinesweeperSolver<StateLogger>;
+
+    // Solver which draws nothing, for benchmarks and batches of games
+    using HeadlessSolver = BasicMinesweeperSolver<NullLogger>;
+
+    // Solver which draws each move on a separate thread
+    using AsyncMinesweeperSolver = BasicMinesweeperSolver<AsyncStateLogger>;
+
+    extern template class BasicMinesweeperSolver<StateLogger>;
+    extern template class BasicMinesweeperSolver<NullLogger>;
+    extern template class BasicMinesweeperSolver<AsyncStateLogger>;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace minesweeper::solver {
+    /**
+     * A fixed size pool of threads which run batches of tasks.
+     * 
+     * Every thread has its own queue of tasks. A thread takes the most
+     * recently queued task from its own queue, and when that is empty it
+     * steals the oldest task from another thread's queue, so uneven tasks
+     * are balanced across the pool.
+     */
+    class ThreadPool {
+        using Task = std::function<void()>;
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _threads;
+
+        // held by the thread in `run`, so that one batch runs at a time
+        std::mutex _run_mutex;
+
+        std::mutex _mutex;
+        std::condition_variable _wake, _done;
+        unsigned long _generation = 0;
+        bool _stopping = false;
+        std::atomic<std::size_t> _pending = 0;
+        std::exception_ptr _error;
+
+        bool take(unsigned int self, Task& task);
+        void work(unsigned int self);
+        void worker(unsigned int self);
+
+    public:
+        /**
+         * Create a pool with the given number of threads, including the
+         * thread which calls `run`.
+         * 
+         * @param threads number of threads to run tasks on. 0 uses the
+         *      number of hardware threads
+         */
+        ThreadPool(unsigned int threads = 0);
+
+        // ThreadPool cannot be copied
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        ~ThreadPool();
+
+        /**
+         * Get the number of threads tasks are run on.
+         * 
+         * @return number of threads
+         */
+        unsigned int size() const;
+
+        /**
+         * Run all of the given tasks on the pool and wait for them to finish.
+         * The calling thread also runs tasks. Calls from different threads
+         * take turns, so a task must not call `run` on its own pool.
+         * 
+         * @param tasks tasks to run
+         * 
+         * @throws rethrows the first exception thrown by a task, after all
+         *      tasks have finished
+         */
+        void run(std::vector<std::function<void()>> tasks);
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <solver/instrumentation.hpp>
+#include <chrono>
+#include <ostream>
+
+namespace minesweeper::solver::trace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Start recording events, discarding any recorded before. Events are
+     * only recorded when instrumented.
+     */
+    void start();
+
+    /**
+     * Stop recording events.
+     */
+    void stop();
+
+    /**
+     * Check whether events are being recorded.
+     * 
+     * @return true between calls to start and stop
+     */
+    bool active();
+
+    /**
+     * Record an event which ran from `begin` to `end` on the calling
+     * thread, if events are being recorded.
+     * 
+     * @param name name of the event, which must outlive the trace
+     * @param category category of the event, which must outlive the trace
+     * @param begin time the event began
+     * @param end time the event ended
+     * @param x x-coordinate of the tile the event acted on, or -1
+     * @param y y-coordinate of the tile the event acted on, or -1
+     */
+    void complete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end, int x = -1, int y = -1);
+
+    /**
+     * Write the events recorded by every thread as a Chrome trace, which
+     * can be opened in Perfetto or chrome://tracing. No thread may be
+     * recording events while they are written.
+     * 
+     * @param out stream to write the trace to
+     */
+    void write(std::ostream& out);
+
+#ifdef MINESWEEPER_INSTRUMENTATION
+    /**
+     * Records the lifetime of the scope it is declared in as an event.
+     */
+    class Scope {
+        const char* _name;
+        const char* _category;
+        int _x, _y;
+        bool _recording;
+        Clock::time_point _begin;
+
+    public:
+        /**
+         * Begin an event which ends when the scope is left.
+         * 
+         * @param name name of the event, which must outlive the trace
+         * @param category category of the event, which must outlive the trace
+         * @param x x-coordinate of the tile the event acts on, or -1
+         * @param y y-coordinate of the tile the event acts on, or -1
+         */
+        Scope(const char* name, const char* category, int x = -1, int y = -1)
+            : _name { name },
+              _category { category },
+              _x { x },
+              _y { y },
+              _recording { active() } {
+            if (_recording) {
+                _begin = Clock::now();
+            }
+        }
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+
+        ~Scope() {
+            if (_recording) {
+                complete(_name, _category, _begin, Clock::now(), _x, _y);
+            }
+        }
+    };
+#else
+    // Records nothing unless instrumented
+    class Scope {
+    public:
+        Scope(const char*, const char*, int = -1, int = -1) {}
+    };
+#endif
+}
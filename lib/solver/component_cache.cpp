@@ -0,0 +1,133 @@
+#include <solver/component_cache.hpp>
+#include <algorithm>
+
+namespace minesweeper::solver::frontier {
+    std::size_t ComponentCache::KeyHash::operator()(const Key& key) const {
+        // FNV-1a over the key's values
+        std::size_t hash = 14695981039346656037ULL;
+        for (auto value : key) {
+            hash = (hash ^ value) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    ComponentCache::ComponentCache(std::size_t capacity)
+        : _capacity { capacity } {}
+
+    ComponentCache::ComponentCache(const ComponentCache& other) {
+        std::lock_guard lock(other._mutex);
+        _capacity = other._capacity;
+        _entries = other._entries;
+        for (auto it = _entries.begin(); it != _entries.end(); it++) {
+            _index.emplace(it->first, it);
+        }
+        _hits = other._hits;
+        _misses = other._misses;
+    }
+
+    ComponentCache& ComponentCache::operator=(const ComponentCache& other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        // Moving the list keeps the copy's index pointing into it
+        ComponentCache copy(other);
+        std::lock_guard lock(_mutex);
+        _capacity = copy._capacity;
+        _entries = std::move(copy._entries);
+        _index = std::move(copy._index);
+        _hits = copy._hits;
+        _misses = copy._misses;
+        return *this;
+    }
+
+    std::shared_ptr<ComponentCache> ComponentCache::shared() {
+        constexpr std::size_t shared_capacity = 1 << 14;
+        static auto cache = std::make_shared<ComponentCache>(shared_capacity);
+        return cache;
+    }
+
+    ComponentCache::Key ComponentCache::key(const Component& component) {
+        std::vector<Key> constraints;
+        for (auto &constraint : component.constraints) {
+            Key encoded = constraint.cells;
+            std::sort(encoded.begin(), encoded.end());
+            encoded.insert(encoded.begin(), { constraint.mines, static_cast<unsigned int>(constraint.cells.size()) });
+            constraints.push_back(std::move(encoded));
+        }
+        std::sort(constraints.begin(), constraints.end());
+
+        Key key { static_cast<unsigned int>(component.cells.size()) };
+        for (auto &constraint : constraints) {
+            key.insert(key.end(), constraint.begin(), constraint.end());
+        }
+        return key;
+    }
+
+    std::optional<Counts> ComponentCache::find(const Key& key) {
+        std::lock_guard lock(_mutex);
+        auto entry = _index.find(key);
+        if (entry == _index.end()) {
+            _misses++;
+            return std::nullopt;
+        }
+
+        _hits++;
+        _entries.splice(_entries.begin(), _entries, entry->second);
+        return entry->second->second;
+    }
+
+    void ComponentCache::insert(const Key& key, const Counts& counts) {
+        std::lock_guard lock(_mutex);
+        if (_capacity == 0) {
+            return;
+        }
+
+        auto entry = _index.find(key);
+        if (entry != _index.end()) {
+            entry->second->second = counts;
+            _entries.splice(_entries.begin(), _entries, entry->second);
+            return;
+        }
+
+        if (_entries.size() == _capacity) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+        _entries.emplace_front(key, counts);
+        _index.insert({ key, _entries.begin() });
+    }
+
+    void ComponentCache::clear() {
+        std::lock_guard lock(_mutex);
+        _entries.clear();
+        _index.clear();
+        _hits = 0;
+        _misses = 0;
+    }
+
+    std::size_t ComponentCache::size() const {
+        std::lock_guard lock(_mutex);
+        return _entries.size();
+    }
+
+    std::size_t ComponentCache::capacity() const {
+        return _capacity;
+    }
+
+    unsigned long long ComponentCache::hits() const {
+        std::lock_guard lock(_mutex);
+        return _hits;
+    }
+
+    unsigned long long ComponentCache::misses() const {
+        std::lock_guard lock(_mutex);
+        return _misses;
+    }
+
+    double ComponentCache::hit_rate() const {
+        std::lock_guard lock(_mutex);
+        auto lookups = _hits + _misses;
+        return lookups > 0 ? static_cast<double>(_hits) / lookups : 0.0;
+    }
+}
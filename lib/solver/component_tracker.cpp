@@ -0,0 +1,131 @@
+#include <solver/component_tracker.hpp>
+
+namespace minesweeper::solver::frontier {
+    /**
+     * Track new components, with no counts yet.
+     * 
+     * @param components components of cells not tracked already
+     */
+    void ComponentTracker::insert(const std::vector<Component>& components) {
+        for (auto &component : components) {
+            auto first = component.cells.front()->coord();
+            for (auto cell : component.cells) {
+                owners[cell] = first;
+                for (auto adjacent : cell->adjacent()) {
+                    if (adjacent->is_hint()) {
+                        owners[adjacent] = first;
+                    }
+                }
+            }
+            entries.insert({ first, { component, std::nullopt } });
+        }
+    }
+
+    /**
+     * Stop tracking a component and its cells.
+     * 
+     * @param first coordinates of the component's first cell
+     */
+    void ComponentTracker::erase(const Coord& first) {
+        auto entry = entries.find(first);
+        for (auto cell : entry->second.component.cells) {
+            owners.erase(cell);
+            for (auto adjacent : cell->adjacent()) {
+                if (auto owner = owners.find(adjacent); owner != owners.end() && owner->second == first) {
+                    owners.erase(owner);
+                }
+            }
+        }
+        entries.erase(entry);
+    }
+
+    std::vector<Component> ComponentTracker::components(const std::set<Node*>& hint_edge, const std::shared_ptr<const std::vector<Node*>>& changes) {
+        auto same_log = !log.owner_before(changes) && !changes.owner_before(log);
+        if (!same_log) {
+            entries.clear();
+            owners.clear();
+            insert(frontier::components(hint_edge));
+        } else if (applied < changes->size()) {
+            // Components with a cell or hint at or next to a changed node are
+            // dirty, and rebuilt from their hints and those next to a changed
+            // node
+            std::set<Coord> dirty;
+            std::set<Node*> hints;
+            auto touch = [&](Node* node) {
+                if (hint_edge.contains(node)) {
+                    hints.insert(node);
+                }
+                if (auto owner = owners.find(node); owner != owners.end()) {
+                    dirty.insert(owner->second);
+                }
+            };
+            for (auto i = applied; i < changes->size(); i++) {
+                auto changed = (*changes)[i];
+                touch(changed);
+                for (auto adjacent : changed->adjacent()) {
+                    touch(adjacent);
+                }
+            }
+            for (auto &first : dirty) {
+                for (auto cell : entries.at(first).component.cells) {
+                    for (auto adjacent : cell->adjacent()) {
+                        if (hint_edge.contains(adjacent)) {
+                            hints.insert(adjacent);
+                        }
+                    }
+                }
+                erase(first);
+            }
+            insert(frontier::components(hints));
+        }
+        log = changes;
+        applied = changes->size();
+
+        std::vector<Component> result;
+        result.reserve(entries.size());
+        for (auto &[first, entry] : entries) {
+            result.push_back(entry.component);
+        }
+        return result;
+    }
+
+    std::vector<std::optional<Counts>> ComponentTracker::find(const std::vector<Component>& components) {
+        std::vector<std::optional<Counts>> counts(components.size());
+        for (auto c = 0U; c < components.size(); c++) {
+            auto &cells = components[c].cells;
+            auto entry = cells.empty() ? entries.end() : entries.find(cells.front()->coord());
+            if (entry != entries.end() && entry->second.counts && entry->second.component.cells.size() == cells.size()) {
+                counts[c] = entry->second.counts;
+                _reused++;
+                continue;
+            }
+            _counted++;
+        }
+        return counts;
+    }
+
+    void ComponentTracker::update(const std::vector<Component>& components, const std::vector<std::optional<Counts>>& counts) {
+        for (auto c = 0U; c < components.size(); c++) {
+            auto &cells = components[c].cells;
+            auto entry = cells.empty() ? entries.end() : entries.find(cells.front()->coord());
+            if (entry != entries.end()) {
+                entry->second.counts = counts[c];
+            }
+        }
+    }
+
+    void ComponentTracker::clear() {
+        entries.clear();
+        owners.clear();
+        log.reset();
+        applied = 0;
+    }
+
+    unsigned long long ComponentTracker::reused() const {
+        return _reused;
+    }
+
+    unsigned long long ComponentTracker::counted() const {
+        return _counted;
+    }
+}
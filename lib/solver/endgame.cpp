@@ -0,0 +1,283 @@
+#include <solver/endgame.hpp>
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <unordered_map>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        using Board = EndgameSolver::Board;
+
+        // A hint, or the mine count, as the cells it covers and its mines
+        struct Constraint {
+            Board cells;
+            unsigned int mines;
+        };
+
+        /**
+         * Depth first enumeration of the mine placements of the covered
+         * cells which satisfy every constraint.
+         */
+        class Enumeration {
+            unsigned int n;
+            std::vector<Constraint> constraints;
+
+            // constraints containing each cell
+            std::vector<std::vector<unsigned int>> cell_constraints;
+
+            std::size_t limit;
+
+            bool place(unsigned int cell, Board mines) {
+                if (cell == n) {
+                    solutions.push_back(mines);
+                    return solutions.size() <= limit;
+                }
+
+                auto assigned = (Board { 2 } << cell) - 1;
+                for (auto value = 0U; value <= 1; value++) {
+                    auto next = mines | (Board { value } << cell);
+                    auto feasible = std::all_of(cell_constraints[cell].begin(), cell_constraints[cell].end(), [&](unsigned int c) {
+                        auto &constraint = constraints[c];
+                        auto have = static_cast<unsigned int>(std::popcount(next & constraint.cells));
+                        auto left = static_cast<unsigned int>(std::popcount(constraint.cells & ~assigned));
+                        return have <= constraint.mines && constraint.mines <= have + left;
+                    });
+                    if (feasible && !place(cell + 1, next)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+        public:
+            std::vector<Board> solutions;
+
+            Enumeration(unsigned int n, std::vector<Constraint> constraints, std::size_t limit)
+                : n { n },
+                  constraints { std::move(constraints) },
+                  cell_constraints(n),
+                  limit { limit } {
+                for (auto c = 0U; c < this->constraints.size(); c++) {
+                    for (auto cell = 0U; cell < n; cell++) {
+                        if (this->constraints[c].cells >> cell & 1) {
+                            cell_constraints[cell].push_back(c);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Enumerate the placements, giving up once there are more than
+             * `limit`.
+             * 
+             * @return false if there were too many placements
+             */
+            bool run() {
+                return place(0, 0);
+            }
+        };
+
+        // Placements still possible as a bitset, then the cells revealed
+        using Key = std::vector<std::uint64_t>;
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const {
+                // FNV-1a over the key's values
+                std::size_t hash = 14695981039346656037ULL;
+                for (auto value : key) {
+                    hash = (hash ^ value) * 1099511628211ULL;
+                }
+                return hash;
+            }
+        };
+
+        /**
+         * Game tree search over the placements still possible, by the
+         * cells revealed so far.
+         */
+        class Search {
+            const std::vector<Board>& solutions;
+            const std::vector<Board>& neighbours;
+            Board all_cells;
+            unsigned long max_positions;
+
+        public:
+            std::unordered_map<Key, double, KeyHash> table;
+
+            Search(const std::vector<Board>& solutions, const std::vector<Board>& neighbours, unsigned long max_positions)
+                : solutions { solutions },
+                  neighbours { neighbours },
+                  all_cells { neighbours.size() == 64 ? ~Board { 0 } : (Board { 1 } << neighbours.size()) - 1 },
+                  max_positions { max_positions } {}
+
+            /**
+             * Find the best cell to reveal, and the chance of winning by
+             * revealing it.
+             * 
+             * @param alive indices of the placements still possible
+             * @param revealed cells revealed so far
+             * 
+             * @return best cell, or -1 if there's no safe cell left, and its
+             *      chance of winning. No value if the search gave up
+             */
+            std::optional<std::pair<int, double>> best(const std::vector<unsigned int>& alive, Board revealed) {
+                Board mine_any = 0, mine_all = all_cells;
+                for (auto s : alive) {
+                    mine_any |= solutions[s];
+                    mine_all &= solutions[s];
+                }
+                auto unrevealed = all_cells & ~revealed;
+                auto safe_all = unrevealed & ~mine_any;
+                if ((mine_any & unrevealed) == (mine_all & unrevealed)) {
+                    // Every cell left is known
+                    return std::pair { safe_all ? std::countr_zero(safe_all) : -1, 1.0 };
+                }
+
+                // Revealing a cell which is safe in every placement is free.
+                // Otherwise try the cells most likely to be safe first: a
+                // cell can't win more often than it survives, so the rest
+                // can be skipped once one wins more often than that
+                std::vector<std::pair<unsigned int, int>> candidates;
+                if (safe_all) {
+                    candidates.push_back({ static_cast<unsigned int>(alive.size()), std::countr_zero(safe_all) });
+                } else {
+                    for (auto cells = unrevealed & ~mine_all; cells; cells &= cells - 1) {
+                        auto cell = std::countr_zero(cells);
+                        auto safe = std::count_if(alive.begin(), alive.end(), [&](unsigned int s) {
+                            return !(solutions[s] >> cell & 1);
+                        });
+                        candidates.push_back({ static_cast<unsigned int>(safe), cell });
+                    }
+                    std::stable_sort(candidates.begin(), candidates.end(), [](auto &a, auto &b) {
+                        return a.first > b.first;
+                    });
+                }
+
+                std::pair<int, double> best_move { -1, -1.0 };
+                for (auto [safe, cell] : candidates) {
+                    if (static_cast<double>(safe) / alive.size() <= best_move.second) {
+                        break;
+                    }
+                    std::map<int, std::vector<unsigned int>> outcomes;
+                    for (auto s : alive) {
+                        if (!(solutions[s] >> cell & 1)) {
+                            outcomes[std::popcount(solutions[s] & neighbours[cell])].push_back(s);
+                        }
+                    }
+
+                    auto win = 0.0;
+                    for (auto &[hint, outcome] : outcomes) {
+                        auto outcome_win = value(outcome, revealed | Board { 1 } << cell);
+                        if (!outcome_win) {
+                            return std::nullopt;
+                        }
+                        win += *outcome_win * outcome.size();
+                    }
+                    win /= alive.size();
+                    if (win > best_move.second) {
+                        best_move = { cell, win };
+                    }
+                }
+                return best_move;
+            }
+
+            /**
+             * Get the chance of winning from a position, playing the best
+             * moves.
+             */
+            std::optional<double> value(const std::vector<unsigned int>& alive, Board revealed) {
+                Key key((solutions.size() + 63) / 64 + 1, 0);
+                for (auto s : alive) {
+                    key[s / 64] |= std::uint64_t { 1 } << (s % 64);
+                }
+                key.back() = revealed;
+                auto entry = table.find(key);
+                if (entry != table.end()) {
+                    return entry->second;
+                }
+                if (table.size() >= max_positions) {
+                    return std::nullopt;
+                }
+
+                auto move = best(alive, revealed);
+                if (!move) {
+                    return std::nullopt;
+                }
+                table.emplace(std::move(key), move->second);
+                return move->second;
+            }
+        };
+    }
+
+    EndgameSolver::EndgameSolver(unsigned long max_positions)
+        : _max_positions { max_positions } {}
+
+    std::optional<EndgameSolver::Move> EndgameSolver::solve(const std::set<Node*>& covered, int mines_left) {
+        _solutions.clear();
+        _positions = 0;
+        if (covered.size() > max_cells || mines_left < 0 || mines_left > static_cast<int>(covered.size())) {
+            return std::nullopt;
+        }
+
+        std::vector<Node*> cells(covered.begin(), covered.end());
+        std::sort(cells.begin(), cells.end(), [](Node* a, Node* b) {
+            return a->coord() < b->coord();
+        });
+        auto bit = [&cells](Node* node) {
+            auto position = std::lower_bound(cells.begin(), cells.end(), node, [](Node* a, Node* b) {
+                return a->coord() < b->coord();
+            });
+            return Board { 1 } << (position - cells.begin());
+        };
+
+        // Constraints of the hints next to the covered cells, and of the
+        // number of mines left
+        std::vector<Board> neighbours(cells.size(), 0);
+        std::set<Node*> hints;
+        for (auto i = 0U; i < cells.size(); i++) {
+            for (auto node : cells[i]->adjacent()) {
+                if (node->value() == Tile::Covered) {
+                    neighbours[i] |= bit(node);
+                } else if (node->is_hint()) {
+                    hints.insert(node);
+                }
+            }
+        }
+        std::vector<Constraint> constraints;
+        for (auto hint : hints) {
+            Board hint_cells = 0;
+            for (auto node : hint->adjacent_covered()) {
+                hint_cells |= bit(node);
+            }
+            constraints.push_back({ hint_cells, hint->adjacent_mines_left() });
+        }
+        auto all_cells = cells.size() == 64 ? ~Board { 0 } : (Board { 1 } << cells.size()) - 1;
+        constraints.push_back({ all_cells, static_cast<unsigned int>(mines_left) });
+
+        Enumeration enumeration(cells.size(), std::move(constraints), max_solutions);
+        if (!enumeration.run() || enumeration.solutions.empty()) {
+            return std::nullopt;
+        }
+        _solutions = std::move(enumeration.solutions);
+
+        Search search(_solutions, neighbours, _max_positions);
+        std::vector<unsigned int> alive(_solutions.size());
+        for (auto s = 0U; s < alive.size(); s++) {
+            alive[s] = s;
+        }
+        auto move = search.best(alive, 0);
+        _positions = search.table.size();
+        if (!move || move->first < 0) {
+            return std::nullopt;
+        }
+        return Move { cells[move->first], move->second };
+    }
+
+    const std::vector<EndgameSolver::Board>& EndgameSolver::solutions() const {
+        return _solutions;
+    }
+
+    std::size_t EndgameSolver::positions() const {
+        return _positions;
+    }
+}
@@ -0,0 +1,530 @@
+#include <solver/enumerator.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        /**
+         * Search state of a single component being counted.
+         */
+        class Search {
+            const Component& component;
+            std::vector<std::vector<unsigned int>> cell_constraints;
+            std::vector<unsigned int> order;
+
+            // per cell: -1 unassigned, 0 safe, 1 mine
+            std::vector<signed char> values;
+            // per constraint: mines still needed and cells still unassigned
+            std::vector<int> needed, unassigned;
+            std::vector<unsigned int> trail;
+            unsigned int mines = 0;
+
+            Counts& counts;
+            unsigned long long& nodes_visited;
+
+            std::optional<Clock::time_point> deadline;
+
+            /**
+             * Order the cells so that each one shares as many constraints as
+             * possible with the cells before it, starting from the cell with
+             * the most constraints.
+             */
+            void order_cells() {
+                auto n = component.cells.size();
+                std::vector<unsigned int> connections(n, 0);
+                std::vector<bool> ordered(n, false);
+
+                for (auto step = 0U; step < n; step++) {
+                    auto best = 0U;
+                    auto found = false;
+                    for (auto i = 0U; i < n; i++) {
+                        if (ordered[i]) {
+                            continue;
+                        }
+                        if (!found
+                            || connections[i] > connections[best]
+                            || (connections[i] == connections[best] && cell_constraints[i].size() > cell_constraints[best].size())) {
+                            best = i;
+                            found = true;
+                        }
+                    }
+
+                    ordered[best] = true;
+                    order.push_back(best);
+                    for (auto c : cell_constraints[best]) {
+                        for (auto cell : component.constraints[c].cells) {
+                            connections[cell]++;
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Assign `value` to `cell` and check its constraints are still
+             * satisfiable.
+             * 
+             * @return constraints of `cell` can still be satisfied
+             */
+            bool assign(unsigned int cell, signed char value) {
+                values[cell] = value;
+                mines += value;
+                trail.push_back(cell);
+
+                auto ok = true;
+                for (auto c : cell_constraints[cell]) {
+                    unassigned[c]--;
+                    needed[c] -= value;
+                    if (needed[c] < 0 || needed[c] > unassigned[c]) {
+                        ok = false;
+                    }
+                }
+                return ok;
+            }
+
+            /**
+             * Undo assignments until only `size` remain on the trail.
+             */
+            void undo(std::size_t size) {
+                while (trail.size() > size) {
+                    auto cell = trail.back();
+                    trail.pop_back();
+
+                    for (auto c : cell_constraints[cell]) {
+                        unassigned[c]++;
+                        needed[c] += values[cell];
+                    }
+                    mines -= values[cell];
+                    values[cell] = -1;
+                }
+            }
+
+            /**
+             * Assign the cells forced by the constraints of every cell on the
+             * trail after `from`: the rest of a constraint's cells are safe
+             * once it has all its mines, and mines once they are all needed.
+             * 
+             * @return no constraint has been violated
+             */
+            bool propagate(std::size_t from) {
+                for (auto t = from; t < trail.size(); t++) {
+                    for (auto c : cell_constraints[trail[t]]) {
+                        if (unassigned[c] == 0) {
+                            continue;
+                        }
+                        signed char forced;
+                        if (needed[c] == 0) {
+                            forced = 0;
+                        } else if (needed[c] == unassigned[c]) {
+                            forced = 1;
+                        } else {
+                            continue;
+                        }
+                        for (auto cell : component.constraints[c].cells) {
+                            if (values[cell] == -1 && !assign(cell, forced)) {
+                                return false;
+                            }
+                        }
+                    }
+                }
+                return true;
+            }
+
+            void tally(double weight = 1) {
+                counts.solutions[mines] += weight;
+                for (auto i = 0U; i < values.size(); i++) {
+                    if (values[i] == 1) {
+                        counts.cell_mines[i][mines] += weight;
+                    }
+                }
+            }
+
+            /**
+             * Check the clock every so many nodes, so that the search can
+             * stop at its deadline.
+             */
+            bool out_of_time() {
+                constexpr unsigned long long check_interval = 256;
+                if (deadline && nodes_visited % check_interval == 0 && Clock::now() >= *deadline) {
+                    timed_out = true;
+                }
+                return timed_out;
+            }
+
+            void search(unsigned int position) {
+                nodes_visited++;
+                if (out_of_time() || (stop_at_first && !last_solution.empty())) {
+                    return;
+                }
+                while (position < order.size() && values[order[position]] != -1) {
+                    position++;
+                }
+                if (position == order.size()) {
+                    if (stop_at_first) {
+                        last_solution = values;
+                    } else {
+                        tally();
+                    }
+                    return;
+                }
+
+                auto cell = order[position];
+                for (signed char value = 0; value <= 1; value++) {
+                    auto mark = trail.size();
+                    if (assign(cell, value) && propagate(mark)) {
+                        search(position + 1);
+                    }
+                    undo(mark);
+                }
+            }
+
+        public:
+            // whether the search stopped at its deadline before finishing
+            bool timed_out = false;
+
+            // values of the cells in the last solution found by `probe`, or
+            // by `run` when stopping at the first solution
+            std::vector<signed char> last_solution;
+
+            // whether `run` stops at the first solution instead of counting
+            bool stop_at_first = false;
+
+            Search(const Component& component, Counts& counts, unsigned long long& nodes_visited, std::optional<Clock::time_point> deadline = {})
+                : component { component },
+                  cell_constraints(component.cells.size()),
+                  values(component.cells.size(), -1),
+                  counts { counts },
+                  nodes_visited { nodes_visited },
+                  deadline { deadline } {
+                for (auto c = 0U; c < component.constraints.size(); c++) {
+                    auto &constraint = component.constraints[c];
+                    needed.push_back(constraint.mines);
+                    unassigned.push_back(constraint.cells.size());
+                    for (auto cell : constraint.cells) {
+                        cell_constraints[cell].push_back(c);
+                    }
+                }
+                order_cells();
+            }
+
+            /**
+             * Count the solutions below one branch of the search tree. The
+             * first `depth` branching cells take the values of the bits of
+             * `branch`, and every branch in [0, 2^depth) together counts the
+             * whole tree exactly once.
+             * 
+             * @param depth number of cells in the branch
+             * @param branch values of the cells in the branch
+             */
+            void run(unsigned int depth = 0, unsigned long branch = 0) {
+                for (auto c = 0U; c < needed.size(); c++) {
+                    if (needed[c] > unassigned[c]) {
+                        return;
+                    }
+                }
+
+                for (auto position = 0U; position < depth; position++) {
+                    auto cell = order[position];
+                    signed char value = (branch >> position) & 1;
+                    if (values[cell] != -1) {
+                        // Forced cells aren't branched on, so they only
+                        // belong to the branches where their bit is 0
+                        if (value) {
+                            return;
+                        }
+                        continue;
+                    }
+
+                    auto mark = trail.size();
+                    if (!assign(cell, value) || !propagate(mark)) {
+                        return;
+                    }
+                }
+                search(depth);
+            }
+
+            /**
+             * Walk one random path down the search tree, choosing uniformly
+             * between the branches which survive propagation. A solution
+             * found is tallied with the product of the number of branches
+             * chosen between.
+             * 
+             * @param rng random number generator to choose branches with
+             * 
+             * @return weight the solution was tallied with, or 0 if the
+             *      path ended in a dead end
+             */
+            double probe(std::mt19937_64& rng) {
+                for (auto c = 0U; c < needed.size(); c++) {
+                    if (needed[c] > unassigned[c]) {
+                        return 0;
+                    }
+                }
+
+                double weight = 1;
+                for (auto position = 0U; position < order.size(); position++) {
+                    auto cell = order[position];
+                    if (values[cell] != -1) {
+                        continue;
+                    }
+
+                    signed char feasible[2];
+                    auto feasible_count = 0;
+                    for (signed char value = 0; value <= 1; value++) {
+                        auto mark = trail.size();
+                        if (assign(cell, value) && propagate(mark)) {
+                            feasible[feasible_count++] = value;
+                        }
+                        undo(mark);
+                    }
+                    if (feasible_count == 0) {
+                        undo(0);
+                        return 0;
+                    }
+
+                    auto value = feasible[std::uniform_int_distribution(0, feasible_count - 1)(rng)];
+                    weight *= feasible_count;
+                    auto mark = trail.size();
+                    assign(cell, value);
+                    propagate(mark);
+                }
+
+                tally(weight);
+                last_solution = values;
+                undo(0);
+                return weight;
+            }
+        };
+    }
+
+    BacktrackingEnumerator::BacktrackingEnumerator(std::shared_ptr<ThreadPool> pool)
+        : _pool { pool } {}
+
+    void BacktrackingEnumerator::set_cache(std::shared_ptr<ComponentCache> cache) {
+        _cache = cache;
+    }
+
+    const std::shared_ptr<ComponentCache>& BacktrackingEnumerator::cache() const {
+        return _cache;
+    }
+
+    void BacktrackingEnumerator::set_patterns(std::shared_ptr<const PatternDatabase> patterns) {
+        _patterns = patterns;
+    }
+
+    Counts BacktrackingEnumerator::count(const Component& component) {
+        Counts counts(component.cells.size());
+        Search(component, counts, _nodes_visited).run();
+        return counts;
+    }
+
+    std::vector<Counts> BacktrackingEnumerator::count(const std::vector<Component>& components) {
+        std::vector<Counts> result;
+        for (auto &counts : count_all(components, std::nullopt)) {
+            result.push_back(std::move(*counts));
+        }
+        return result;
+    }
+
+    std::vector<std::optional<Counts>> BacktrackingEnumerator::count_until(const std::vector<Component>& components, Clock::time_point deadline) {
+        return count_all(components, deadline);
+    }
+
+    /**
+     * Count the solutions of each of the given components, looking up the
+     * components in the pattern database and cache and searching the rest.
+     * 
+     * @param components components to count the solutions of
+     * @param deadline time to stop counting at, if any
+     * 
+     * @return solution counts of each component, or no value for components
+     *      which weren't counted by the deadline
+     */
+    std::vector<std::optional<Counts>> BacktrackingEnumerator::count_all(const std::vector<Component>& components, std::optional<Clock::time_point> deadline) {
+        if (!_cache && !_patterns) {
+            return search_all(components, deadline);
+        }
+
+        std::vector<std::optional<Counts>> result(components.size());
+        std::vector<ComponentCache::Key> keys(components.size());
+        std::vector<unsigned int> missing;
+        std::vector<Component> missing_components;
+        for (auto c = 0U; c < components.size(); c++) {
+            if (components[c].cells.size() <= ComponentCache::max_cells) {
+                if (_patterns) {
+                    result[c] = _patterns->find(components[c]);
+                }
+                if (!result[c] && _cache) {
+                    keys[c] = ComponentCache::key(components[c]);
+                    result[c] = _cache->find(keys[c]);
+                }
+            }
+            if (!result[c]) {
+                missing.push_back(c);
+                missing_components.push_back(components[c]);
+            }
+        }
+
+        auto counted = search_all(missing_components, deadline);
+        for (auto m = 0U; m < missing.size(); m++) {
+            auto c = missing[m];
+            if (counted[m] && !keys[c].empty()) {
+                _cache->insert(keys[c], *counted[m]);
+            }
+            result[c] = std::move(counted[m]);
+        }
+        return result;
+    }
+
+    /**
+     * Search the solutions of each of the given components, in parallel if
+     * the enumerator has a thread pool.
+     * 
+     * @param components components to count the solutions of
+     * @param deadline time to stop counting at, if any
+     * 
+     * @return solution counts of each component, or no value for components
+     *      which weren't counted by the deadline
+     */
+    std::vector<std::optional<Counts>> BacktrackingEnumerator::search_all(const std::vector<Component>& components, std::optional<Clock::time_point> deadline) {
+        std::vector<std::optional<Counts>> result;
+        if (!_pool || _pool->size() == 1) {
+            for (auto &component : components) {
+                Counts counts(component.cells.size());
+                Search search(component, counts, _nodes_visited, deadline);
+                search.run();
+                if (search.timed_out) {
+                    result.emplace_back();
+                } else {
+                    result.emplace_back(std::move(counts));
+                }
+            }
+            return result;
+        }
+
+        // Components smaller than this aren't worth splitting
+        constexpr unsigned int min_split_cells = 16;
+        constexpr unsigned int tasks_per_thread = 8;
+        auto split_depth = static_cast<unsigned int>(std::bit_width(tasks_per_thread * _pool->size() - 1));
+
+        // One task per branch of each component's search tree
+        struct Task {
+            unsigned int component, depth;
+            unsigned long branch;
+            Counts counts;
+            unsigned long long nodes_visited = 0;
+            bool timed_out = false;
+        };
+        std::vector<Task> tasks;
+        for (auto c = 0U; c < components.size(); c++) {
+            auto cell_count = components[c].cells.size();
+            result.emplace_back(Counts(cell_count));
+
+            auto depth = cell_count < min_split_cells ? 0U : split_depth;
+            for (auto branch = 0UL; branch < 1UL << depth; branch++) {
+                tasks.push_back({ c, depth, branch, Counts(cell_count) });
+            }
+        }
+
+        std::vector<std::function<void()>> jobs;
+        for (auto &task : tasks) {
+            jobs.push_back([&task, &components, deadline] {
+                Search search(components[task.component], task.counts, task.nodes_visited, deadline);
+                search.run(task.depth, task.branch);
+                task.timed_out = search.timed_out;
+            });
+        }
+        _pool->run(std::move(jobs));
+
+        // Merge in task order, independent of which thread ran what
+        for (auto &task : tasks) {
+            auto &counts = result[task.component];
+            if (task.timed_out) {
+                counts.reset();
+            } else if (counts) {
+                *counts += task.counts;
+            }
+            _nodes_visited += task.nodes_visited;
+        }
+        return result;
+    }
+
+    unsigned long long BacktrackingEnumerator::nodes_visited() const {
+        return _nodes_visited;
+    }
+
+
+    // ProbeEstimator implementation
+    ProbeEstimator::ProbeEstimator(unsigned long seed)
+        : _rng { seed } {}
+
+    Estimate ProbeEstimator::estimate(const Component& component, Clock::time_point deadline, unsigned long min_probes, unsigned long max_probes) {
+        auto n = component.cells.size();
+        Estimate estimate { Counts(n), std::vector<double>(n, 1.0), 0 };
+
+        unsigned long long nodes_visited = 0;
+        Search search(component, estimate.counts, nodes_visited);
+
+        // Sums for the variance of each cell's ratio estimate
+        double weight_sum = 0, weight_squared_sum = 0;
+        std::vector<double> mine_weight_squared_sum(n, 0.0);
+
+        while (estimate.probes < max_probes && (estimate.probes < min_probes || Clock::now() < deadline)) {
+            auto weight = search.probe(_rng);
+            estimate.probes++;
+            if (weight == 0) {
+                continue;
+            }
+
+            weight_sum += weight;
+            weight_squared_sum += weight * weight;
+            for (auto i = 0U; i < n; i++) {
+                if (search.last_solution[i] == 1) {
+                    mine_weight_squared_sum[i] += weight * weight;
+                }
+            }
+        }
+
+        auto probes = static_cast<double>(estimate.probes);
+        if (estimate.probes > 1 && weight_sum > 0) {
+            for (auto i = 0U; i < n; i++) {
+                // Delta method variance of sum(weight * mine) / sum(weight)
+                auto p = estimate.counts.cell_total(i) / weight_sum;
+                auto residuals = mine_weight_squared_sum[i] * (1 - 2 * p) + p * p * weight_squared_sum;
+                auto variance = residuals / (weight_sum * weight_sum) * probes / (probes - 1);
+                estimate.margins[i] = 1.96 * std::sqrt(std::max(variance, 0.0));
+            }
+        }
+
+        // Average of the probes
+        for (auto &solutions : estimate.counts.solutions) {
+            solutions /= probes;
+        }
+        for (auto &cell_mines : estimate.counts.cell_mines) {
+            for (auto &mines : cell_mines) {
+                mines /= probes;
+            }
+        }
+        return estimate;
+    }
+
+    std::optional<std::vector<bool>> random_solution(const Component& component, std::mt19937_64& rng) {
+        Counts counts(component.cells.size());
+        unsigned long long nodes_visited = 0;
+        Search search(component, counts, nodes_visited);
+
+        // Random probes reach a solution quickly unless dead ends are common
+        constexpr unsigned int max_probes = 64;
+        for (auto probe = 0U; probe < max_probes && search.last_solution.empty(); probe++) {
+            search.probe(rng);
+        }
+        if (search.last_solution.empty()) {
+            search.stop_at_first = true;
+            search.run();
+        }
+        if (search.last_solution.empty()) {
+            return std::nullopt;
+        }
+        return std::vector<bool>(search.last_solution.begin(), search.last_solution.end());
+    }
+}
\ No newline at end of file
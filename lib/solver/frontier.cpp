@@ -0,0 +1,244 @@
+#include <solver/frontier.hpp>
+#include <solver/trace.hpp>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <map>
+#include <cmath>
+#include <type_traits>
+
+namespace minesweeper::solver::frontier {
+    // Counts implementation
+    Counts::Counts(unsigned int cell_count)
+        : solutions(cell_count + 1),
+          cell_mines(cell_count, std::vector<double>(cell_count + 1)) {}
+
+    double Counts::total() const {
+        return std::accumulate(solutions.begin(), solutions.end(), 0.0);
+    }
+
+    double Counts::cell_total(unsigned int i) const {
+        return std::accumulate(cell_mines[i].begin(), cell_mines[i].end(), 0.0);
+    }
+
+    Counts& Counts::operator+=(const Counts& other) {
+        for (auto k = 0U; k < solutions.size(); k++) {
+            solutions[k] += other.solutions[k];
+        }
+        for (auto i = 0U; i < cell_mines.size(); i++) {
+            for (auto k = 0U; k < cell_mines[i].size(); k++) {
+                cell_mines[i][k] += other.cell_mines[i][k];
+            }
+        }
+        return *this;
+    }
+
+
+    std::vector<Component> components(const std::set<Node*>& hint_edge) {
+        trace::Scope scope("components", "frontier");
+        // Group the hints by the covered cells they share
+        std::map<Node*, Node*> parent;
+        auto find = [&](Node* node) {
+            while (parent[node] != node) {
+                node = parent[node] = parent[parent[node]];
+            }
+            return node;
+        };
+
+        // Covered cells of each hint, found once
+        std::unordered_map<Node*, std::set<Node*>> hint_cells;
+        std::unordered_map<Node*, Node*> cell_hint;
+        for (auto hint : hint_edge) {
+            parent[hint] = hint;
+            hint_cells[hint] = hint->adjacent_covered();
+        }
+        for (auto hint : hint_edge) {
+            for (auto cell : hint_cells[hint]) {
+                auto [it, inserted] = cell_hint.insert({cell, hint});
+                if (!inserted) {
+                    parent[find(hint)] = find(it->second);
+                }
+            }
+        }
+
+        std::map<Node*, std::vector<Node*>> groups;
+        for (auto hint : hint_edge) {
+            groups[find(hint)].push_back(hint);
+        }
+
+        std::vector<Component> result;
+        for (auto &[root, hints] : groups) {
+            Component component;
+            for (auto hint : hints) {
+                for (auto cell : hint_cells[hint]) {
+                    component.cells.push_back(cell);
+                }
+            }
+            if (component.cells.empty()) {
+                continue;
+            }
+
+            std::sort(component.cells.begin(), component.cells.end(), [](Node* a, Node* b) {
+                return a->coord() < b->coord();
+            });
+            component.cells.erase(std::unique(component.cells.begin(), component.cells.end()), component.cells.end());
+
+            std::unordered_map<Node*, unsigned int> index;
+            for (auto i = 0U; i < component.cells.size(); i++) {
+                index.insert({component.cells[i], i});
+            }
+            for (auto hint : hints) {
+                Constraint constraint { {}, hint->adjacent_mines_left() };
+                for (auto cell : hint_cells[hint]) {
+                    constraint.cells.push_back(index[cell]);
+                }
+                if (!constraint.cells.empty()) {
+                    std::sort(constraint.cells.begin(), constraint.cells.end());
+                    component.constraints.push_back(std::move(constraint));
+                }
+            }
+            result.push_back(std::move(component));
+        }
+
+        std::sort(result.begin(), result.end(), [](const Component& a, const Component& b) {
+            return a.cells.front()->coord() < b.cells.front()->coord();
+        });
+        return result;
+    }
+
+    /**
+     * Convolve two series of counts bucketed by number of mines.
+     * 
+     * @return counts of combined solutions, by total number of mines
+     */
+    template <typename Number>
+    static std::vector<Number> convolve(const std::vector<Number>& left, const std::vector<Number>& right) {
+        std::vector<Number> result(left.size() + right.size() - 1, Number(0));
+        for (auto i = 0U; i < left.size(); i++) {
+            if (left[i] == Number(0)) {
+                continue;
+            }
+            for (auto j = 0U; j < right.size(); j++) {
+                result[i + j] += left[i] * right[j];
+            }
+        }
+
+        // Rescale so that chains of convolutions don't overflow
+        if constexpr (std::is_floating_point_v<Number>) {
+            auto max = *std::max_element(result.begin(), result.end());
+            if (max > 0) {
+                for (auto &value : result) {
+                    value /= max;
+                }
+            }
+        }
+        return result;
+    }
+
+    Probabilities combine(const std::vector<Counts>& counts, unsigned int interior_cells, int mines_left) {
+        return combine<numeric::Float>(counts, interior_cells, mines_left);
+    }
+
+    template <typename Numeric>
+    BasicProbabilities<typename Numeric::value_type> combine(const std::vector<Counts>& counts, unsigned int interior_cells, int mines_left) {
+        using Number = typename Numeric::value_type;
+        auto component_count = counts.size();
+        auto convert = [](const std::vector<double>& values) {
+            std::vector<Number> converted;
+            for (auto value : values) {
+                converted.push_back(Numeric::count(value));
+            }
+            return converted;
+        };
+
+        // Solutions of all components before / after each component
+        std::vector<std::vector<Number>> solutions;
+        for (auto &component : counts) {
+            solutions.push_back(convert(component.solutions));
+        }
+        std::vector<std::vector<Number>> prefix(component_count + 1, { Number(1) });
+        std::vector<std::vector<Number>> suffix(component_count + 1, { Number(1) });
+        for (auto c = 0U; c < component_count; c++) {
+            prefix[c + 1] = convolve(prefix[c], solutions[c]);
+        }
+        for (auto c = component_count; c > 0; c--) {
+            suffix[c - 1] = convolve(suffix[c], solutions[c - 1]);
+        }
+        auto &all = prefix[component_count];
+
+        // C(interior_cells, mines_left - k), all scaled by the same factor
+        std::vector<Number> weights(all.size(), Number(1));
+        std::vector<unsigned int> weighted_ks, interior_mines;
+        for (auto k = 0U; k < all.size(); k++) {
+            auto mines = mines_left - static_cast<int>(k);
+            if (all[k] > Number(0) && mines >= 0 && mines <= static_cast<int>(interior_cells)) {
+                weighted_ks.push_back(k);
+                interior_mines.push_back(mines);
+            }
+        }
+        auto weighted = !weighted_ks.empty();
+        if (weighted) {
+            std::fill(weights.begin(), weights.end(), Number(0));
+            auto binomials = Numeric::binomials(interior_cells, interior_mines);
+            for (auto i = 0U; i < weighted_ks.size(); i++) {
+                weights[weighted_ks[i]] = binomials[i];
+            }
+        }
+
+        BasicProbabilities<Number> probabilities { {}, Number(0), weighted };
+        for (auto c = 0U; c < component_count; c++) {
+            auto &component = counts[c];
+            auto others = convolve(prefix[c], suffix[c + 1]);
+
+            // Weight of a solution of this component with k mines, summed
+            // over the solutions of every other component
+            std::vector<Number> component_weights(component.solutions.size(), Number(0));
+            for (auto k = 0U; k < component.solutions.size(); k++) {
+                for (auto j = 0U; j < others.size(); j++) {
+                    component_weights[k] += others[j] * weights[k + j];
+                }
+            }
+
+            Number total(0);
+            for (auto k = 0U; k < component.solutions.size(); k++) {
+                total += solutions[c][k] * component_weights[k];
+            }
+
+            std::vector<Number> cells;
+            for (auto &cell_mines : component.cell_mines) {
+                Number mines(0);
+                for (auto k = 0U; k < cell_mines.size(); k++) {
+                    if (cell_mines[k] != 0) {
+                        mines += Numeric::count(cell_mines[k]) * component_weights[k];
+                    }
+                }
+                cells.push_back(total > Number(0) ? mines / total : Number(0));
+            }
+            probabilities.cells.push_back(std::move(cells));
+        }
+
+        // Expected number of mines left for the interior
+        if (interior_cells > 0) {
+            // Solutions using more mines than are left count against the
+            // interior when they can't be weighted, kept apart so that
+            // no Number goes negative
+            Number total(0), interior_mines(0), excess_mines(0);
+            for (auto k = 0U; k < all.size(); k++) {
+                auto mines = mines_left - static_cast<int>(k);
+                total += all[k] * weights[k];
+                if (mines > 0) {
+                    interior_mines += all[k] * weights[k] * Number(mines);
+                } else if (mines < 0) {
+                    excess_mines += all[k] * weights[k] * Number(-mines);
+                }
+            }
+            auto p = total > Number(0) ? (interior_mines - excess_mines) / total / Number(interior_cells) : Number(0);
+            probabilities.interior = std::clamp(p, Number(0), Number(1));
+        }
+        return probabilities;
+    }
+
+    template BasicProbabilities<numeric::Float::value_type> combine<numeric::Float>(const std::vector<Counts>&, unsigned int, int);
+    template BasicProbabilities<numeric::LogSpace::value_type> combine<numeric::LogSpace>(const std::vector<Counts>&, unsigned int, int);
+    template BasicProbabilities<numeric::Exact::value_type> combine<numeric::Exact>(const std::vector<Counts>&, unsigned int, int);
+}
@@ -0,0 +1,66 @@
+#include <solver/instrumentation.hpp>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+namespace minesweeper::solver {
+    namespace {
+        thread_local unsigned long long allocation_count = 0;
+    }
+
+    const char* phase_name(Phase phase) {
+        switch (phase) {
+            case Phase::Opening:
+                return "opening";
+            case Phase::Basic:
+                return "basic";
+            case Phase::Advanced:
+                return "advanced";
+            default:
+                return "probable";
+        }
+    }
+
+    std::string GameStats::json() const {
+        std::ostringstream out;
+        out << "{\"phases\":{";
+        auto first = true;
+        for (auto &[phase, stats] : phases) {
+            out << (first ? "" : ",") << "\"" << phase_name(phase) << "\":{"
+                << "\"passes\":" << stats.passes
+                << ",\"time_ns\":" << stats.time.count()
+                << ",\"moves\":" << stats.moves << "}";
+            first = false;
+        }
+        out << "},\"systems\":" << counting.systems
+            << ",\"equations\":" << counting.equations
+            << ",\"independent_variables\":" << counting.independent_variables
+            << ",\"nodes_visited\":" << counting.nodes_visited
+            << ",\"allocations\":" << allocations << "}";
+        return out.str();
+    }
+
+    unsigned long long allocations() {
+        return allocation_count;
+    }
+}
+
+#ifdef MINESWEEPER_INSTRUMENTATION
+// Count the allocations of the program. The nothrow and array forms call
+// these by default, aligned allocations aren't counted
+void* operator new(std::size_t size) {
+    minesweeper::solver::allocation_count++;
+    if (auto memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
@@ -0,0 +1,218 @@
+#include <solver/lookahead.hpp>
+#include <solver/sampler.hpp>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <unordered_map>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        // Largest value of a hint
+        constexpr unsigned int max_hint = 8;
+
+        /**
+         * Get the covered cells adjacent to `node`, other than `revealed`.
+         */
+        std::set<Node*> covered_except(const Node* node, Node* revealed) {
+            auto covered = node->adjacent_covered();
+            covered.erase(revealed);
+            return covered;
+        }
+
+        /**
+         * Check whether revealing `cell` as hint `value` lets the basic or
+         * pairwise hint rules flag or uncover another cell.
+         */
+        bool unlocks(Node* cell, unsigned int value) {
+            int mines = value;
+            for (auto node : cell->adjacent()) {
+                mines -= node->value() == Tile::Flag;
+            }
+            auto cells = cell->adjacent_covered();
+            if (mines < 0 || mines > static_cast<int>(cells.size())) {
+                return false;
+            }
+            if (!cells.empty() && (mines == 0 || mines == static_cast<int>(cells.size()))) {
+                return true;
+            }
+
+            // Hints next to the cell lose it from their covered cells
+            for (auto node : cell->adjacent()) {
+                if (!node->is_hint()) {
+                    continue;
+                }
+                auto hint_cells = covered_except(node, cell);
+                if (!hint_cells.empty() && node->adjacent_mines_left() == hint_cells.size()) {
+                    return true;
+                }
+            }
+
+            // Pairs of the new hint and a hint sharing its cells
+            std::set<Node*> hints;
+            for (auto node : cells) {
+                for (auto adjacent : node->adjacent()) {
+                    if (adjacent->is_hint()) {
+                        hints.insert(adjacent);
+                    }
+                }
+            }
+            for (auto hint : hints) {
+                auto hint_cells = covered_except(hint, cell);
+                int hint_mines = hint->adjacent_mines_left();
+                if (std::includes(cells.begin(), cells.end(), hint_cells.begin(), hint_cells.end())) {
+                    auto rest = cells.size() - hint_cells.size();
+                    if (rest > 0 && (mines == hint_mines || mines - hint_mines == static_cast<int>(rest))) {
+                        return true;
+                    }
+                }
+                if (std::includes(hint_cells.begin(), hint_cells.end(), cells.begin(), cells.end())) {
+                    auto rest = hint_cells.size() - cells.size();
+                    if (rest > 0 && (mines == hint_mines || hint_mines - mines == static_cast<int>(rest))) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    }
+
+    double Score::value() const {
+        return survival * (1 + progress_weight * progress);
+    }
+
+    LookaheadPolicy::LookaheadPolicy(unsigned int rollouts, unsigned int candidates, unsigned long seed, std::shared_ptr<ThreadPool> pool)
+        : _rollouts { rollouts },
+          _candidates { candidates },
+          _seed { seed },
+          _pool { pool } {}
+
+    std::vector<Score> LookaheadPolicy::score(const std::vector<Component>& components, const std::set<Node*>& covered, int mines_left) const {
+        // Least probable mines first, ties broken by coordinate
+        std::vector<Node*> candidates(covered.begin(), covered.end());
+        std::sort(candidates.begin(), candidates.end(), [](Node* a, Node* b) {
+            return std::pair { a->mine_probability(), a->coord() } < std::pair { b->mine_probability(), b->coord() };
+        });
+        candidates.resize(std::min<std::size_t>(candidates.size(), _candidates));
+
+        // Cells whose values decide the candidates' hints, and where they
+        // are in the hint edge's components
+        std::vector<Node*> relevant;
+        std::unordered_map<Node*, unsigned int> relevant_index;
+        auto add_relevant = [&](Node* node) {
+            if (relevant_index.insert({ node, relevant.size() }).second) {
+                relevant.push_back(node);
+            }
+        };
+        for (auto candidate : candidates) {
+            add_relevant(candidate);
+            for (auto node : candidate->adjacent_covered()) {
+                add_relevant(node);
+            }
+        }
+
+        // Position of each frontier cell in a sampled configuration, which
+        // numbers the cells component by component
+        std::unordered_map<Node*, unsigned int> frontier_cell;
+        for (auto &component : components) {
+            for (auto cell : component.cells) {
+                frontier_cell.insert({ cell, static_cast<unsigned int>(frontier_cell.size()) });
+            }
+        }
+        auto interior_cells = static_cast<unsigned int>(covered.size() - frontier_cell.size());
+
+        // Boards are drawn up front, on this thread, so that they don't
+        // depend on how rollouts are split between threads
+        MarkovChainSampler sampler(_seed, burn_in * 2);
+        auto boards = sampler.configurations(components, interior_cells, std::max(mines_left, 0), _rollouts);
+
+        // Whether each candidate makes progress for each hint it may reveal
+        std::vector<std::array<bool, max_hint + 1>> progress_table(candidates.size());
+        std::vector<std::vector<unsigned int>> neighbours(candidates.size());
+        std::vector<unsigned int> flags(candidates.size(), 0);
+        for (auto k = 0U; k < candidates.size(); k++) {
+            for (auto value = 0U; value <= max_hint; value++) {
+                progress_table[k][value] = unlocks(candidates[k], value);
+            }
+            for (auto node : candidates[k]->adjacent()) {
+                if (node->value() == Tile::Flag) {
+                    flags[k]++;
+                } else if (node->value() == Tile::Covered) {
+                    neighbours[k].push_back(relevant_index[node]);
+                }
+            }
+        }
+
+        // Tallies of each rollout task, merged in order afterwards
+        struct Tally {
+            std::vector<unsigned long> safe, progress;
+        };
+        auto tasks = _pool ? std::max(_pool->size(), 1U) : 1U;
+        std::vector<Tally> tallies(tasks, { std::vector<unsigned long>(candidates.size(), 0), std::vector<unsigned long>(candidates.size(), 0) });
+
+        auto rollout = [&](unsigned int first, unsigned int last, Tally& tally) {
+            std::vector<bool> mines(relevant.size());
+            for (auto r = first; r < last; r++) {
+                // Relevant interior cells are a uniform draw from the
+                // interior of the mines the board leaves it
+                std::mt19937_64 rng(_seed + r);
+                std::uniform_real_distribution<double> uniform(0.0, 1.0);
+                auto &board = boards[r];
+                auto interior_mines = board.interior_mines, interior_left = interior_cells;
+                for (auto i = 0U; i < relevant.size(); i++) {
+                    auto cell = frontier_cell.find(relevant[i]);
+                    if (cell != frontier_cell.end()) {
+                        mines[i] = board.cells[cell->second];
+                    } else {
+                        mines[i] = uniform(rng) * interior_left < interior_mines;
+                        interior_mines -= mines[i];
+                        interior_left--;
+                    }
+                }
+
+                for (auto k = 0U; k < candidates.size(); k++) {
+                    if (mines[relevant_index.at(candidates[k])]) {
+                        continue;
+                    }
+                    auto value = flags[k];
+                    for (auto i : neighbours[k]) {
+                        value += mines[i];
+                    }
+                    tally.safe[k]++;
+                    tally.progress[k] += progress_table[k][std::min(value, max_hint)];
+                }
+            }
+        };
+
+        auto rollouts = static_cast<unsigned int>(boards.size());
+        if (tasks == 1) {
+            rollout(0, rollouts, tallies[0]);
+        } else {
+            std::vector<std::function<void()>> jobs;
+            for (auto t = 0U; t < tasks; t++) {
+                auto first = rollouts * t / tasks;
+                auto last = rollouts * (t + 1) / tasks;
+                jobs.push_back([&, first, last, t] { rollout(first, last, tallies[t]); });
+            }
+            _pool->run(jobs);
+        }
+
+        std::vector<Score> scores;
+        for (auto k = 0U; k < candidates.size(); k++) {
+            unsigned long safe = 0, progress = 0;
+            for (auto &tally : tallies) {
+                safe += tally.safe[k];
+                progress += tally.progress[k];
+            }
+            Score score { candidates[k], 1.0 - candidates[k]->mine_probability(), 0.0 };
+            score.progress = safe > 0 ? static_cast<double>(progress) / safe : 0.0;
+            scores.push_back(score);
+        }
+
+        // Candidates are still in order of their chance of surviving, which
+        // breaks ties, e.g. when none of them can make progress
+        std::stable_sort(scores.begin(), scores.end(), [](const Score& a, const Score& b) {
+            return a.value() > b.value();
+        });
+        return scores;
+    }
+}
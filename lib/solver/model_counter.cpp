@@ -0,0 +1,241 @@
+#include <solver/model_counter.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        using Polynomial = std::vector<double>;
+
+        Polynomial multiply(const Polynomial& a, const Polynomial& b) {
+            Polynomial product(a.size() + b.size() - 1, 0.0);
+            for (auto i = 0U; i < a.size(); i++) {
+                if (a[i] == 0) {
+                    continue;
+                }
+                for (auto j = 0U; j < b.size(); j++) {
+                    product[i + j] += a[i] * b[j];
+                }
+            }
+            return product;
+        }
+
+        /**
+         * Counts of independent parts of a residual multiplied together, by
+         * the number of mines used.
+         */
+        struct Product {
+            Polynomial solutions { 1 };
+
+            // counts of the solutions where each cell is a mine
+            std::vector<std::pair<unsigned int, Polynomial>> cells;
+
+            /**
+             * Multiply in an independent part with the given counts.
+             */
+            void multiply(const Polynomial& part_solutions, std::vector<std::pair<unsigned int, Polynomial>> part_cells) {
+                for (auto &[cell, mines] : cells) {
+                    mines = frontier::multiply(mines, part_solutions);
+                }
+                for (auto &[cell, mines] : part_cells) {
+                    cells.push_back({ cell, frontier::multiply(mines, solutions) });
+                }
+                solutions = frontier::multiply(solutions, part_solutions);
+            }
+
+            /**
+             * Get the counts of the product over `cells`, in their order.
+             */
+            Counts counts(const std::vector<unsigned int>& order) const {
+                Counts counts(order.size());
+                std::copy_n(solutions.begin(), std::min(solutions.size(), counts.solutions.size()), counts.solutions.begin());
+                for (auto &[cell, mines] : cells) {
+                    auto position = std::lower_bound(order.begin(), order.end(), cell) - order.begin();
+                    auto &cell_mines = counts.cell_mines[position];
+                    std::copy_n(mines.begin(), std::min(mines.size(), cell_mines.size()), cell_mines.begin());
+                }
+                return counts;
+            }
+        };
+
+        /**
+         * Renumber constraints over the sorted global `cells` to their
+         * positions in `cells`.
+         */
+        Component local_component(const std::vector<unsigned int>& cells, const std::vector<Constraint>& constraints) {
+            Component component { std::vector<Node*>(cells.size()), {} };
+            for (auto &constraint : constraints) {
+                Constraint local { {}, constraint.mines };
+                for (auto cell : constraint.cells) {
+                    local.cells.push_back(std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin());
+                }
+                component.constraints.push_back(std::move(local));
+            }
+            return component;
+        }
+    }
+
+    ModelCounter::ModelCounter(std::size_t cache_capacity)
+        : _cache { cache_capacity } {}
+
+    Counts ModelCounter::count(const Component& component) {
+        std::vector<unsigned int> cells(component.cells.size());
+        std::iota(cells.begin(), cells.end(), 0);
+        return propagate_and_count(cells, component.constraints, std::nullopt);
+    }
+
+    /**
+     * Count the models of a residual whose constraints are connected and
+     * force no cells, by branching on its most constrained cell. Results
+     * are cached by the residual's constraint structure.
+     * 
+     * @param cells sorted cells of the residual
+     * @param constraints constraints over `cells`
+     * 
+     * @return counts of the residual, in the order of `cells`
+     */
+    Counts ModelCounter::count_residual(const std::vector<unsigned int>& cells, const std::vector<Constraint>& constraints) {
+        auto key = ComponentCache::key(local_component(cells, constraints));
+        if (auto cached = _cache.find(key)) {
+            return std::move(*cached);
+        }
+
+        std::vector<unsigned int> occurrences(cells.size(), 0);
+        for (auto &constraint : constraints) {
+            for (auto cell : constraint.cells) {
+                occurrences[std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin()]++;
+            }
+        }
+        auto branch = cells[std::max_element(occurrences.begin(), occurrences.end()) - occurrences.begin()];
+
+        _decisions++;
+        Counts counts(cells.size());
+        for (auto value = 0U; value <= 1; value++) {
+            counts += propagate_and_count(cells, constraints, std::pair { branch, value });
+        }
+
+        _cache.insert(key, counts);
+        return counts;
+    }
+
+    /**
+     * Count the models of a residual after assigning a cell, by propagating
+     * the constraints it forces and multiplying the counts of the
+     * independent components left.
+     * 
+     * @param cells sorted cells of the residual
+     * @param constraints constraints over `cells`
+     * @param assignment cell to assign and its value, if any
+     * 
+     * @return counts of the residual, in the order of `cells`
+     */
+    Counts ModelCounter::propagate_and_count(const std::vector<unsigned int>& cells, const std::vector<Constraint>& constraints, std::optional<std::pair<unsigned int, unsigned int>> assignment) {
+        std::vector<signed char> values(cells.size(), -1);
+        auto position = [&cells](unsigned int cell) {
+            return std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin();
+        };
+        if (assignment) {
+            values[position(assignment->first)] = assignment->second;
+        }
+
+        // Unit propagation of the cardinality constraints
+        std::vector<Constraint> residual;
+        auto changed = true;
+        while (changed) {
+            changed = false;
+            residual.clear();
+            for (auto &constraint : constraints) {
+                Constraint left { {}, 0 };
+                int needed = constraint.mines;
+                for (auto cell : constraint.cells) {
+                    auto value = values[position(cell)];
+                    if (value == -1) {
+                        left.cells.push_back(cell);
+                    } else {
+                        needed -= value;
+                    }
+                }
+                if (needed < 0 || needed > static_cast<int>(left.cells.size())) {
+                    // Conflict: no models under this assignment
+                    return Counts(cells.size());
+                }
+                if (left.cells.empty()) {
+                    continue;
+                }
+                if (needed == 0 || needed == static_cast<int>(left.cells.size())) {
+                    for (auto cell : left.cells) {
+                        values[position(cell)] = needed == 0 ? 0 : 1;
+                    }
+                    changed = true;
+                }
+                left.mines = needed;
+                residual.push_back(std::move(left));
+            }
+        }
+
+        Product product;
+        for (auto i = 0U; i < cells.size(); i++) {
+            if (values[i] == 1) {
+                product.multiply({ 0, 1 }, { { cells[i], { 0, 1 } } });
+            } else if (values[i] == -1) {
+                values[i] = -2;
+            }
+        }
+
+        // Split the unassigned cells into independent components
+        std::vector<unsigned int> parent(cells.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](unsigned int i) {
+            while (parent[i] != i) {
+                i = parent[i] = parent[parent[i]];
+            }
+            return i;
+        };
+        for (auto &constraint : residual) {
+            auto root = find(position(constraint.cells.front()));
+            for (auto cell : constraint.cells) {
+                parent[find(position(cell))] = root;
+            }
+        }
+
+        std::vector<std::vector<unsigned int>> part_cells(cells.size());
+        std::vector<std::vector<Constraint>> part_constraints(cells.size());
+        for (auto i = 0U; i < cells.size(); i++) {
+            if (values[i] == -2) {
+                part_cells[find(i)].push_back(cells[i]);
+            }
+        }
+        for (auto &constraint : residual) {
+            part_constraints[find(position(constraint.cells.front()))].push_back(std::move(constraint));
+        }
+
+        for (auto root = 0U; root < cells.size(); root++) {
+            if (part_cells[root].empty()) {
+                continue;
+            }
+            if (part_constraints[root].empty()) {
+                // An unconstrained cell may be a mine or not
+                product.multiply({ 1, 1 }, { { part_cells[root].front(), { 0, 1 } } });
+                continue;
+            }
+
+            auto part = count_residual(part_cells[root], part_constraints[root]);
+            if (part.total() == 0) {
+                return Counts(cells.size());
+            }
+            std::vector<std::pair<unsigned int, Polynomial>> mines;
+            for (auto i = 0U; i < part_cells[root].size(); i++) {
+                mines.push_back({ part_cells[root][i], std::move(part.cell_mines[i]) });
+            }
+            product.multiply(part.solutions, std::move(mines));
+        }
+        return product.counts(cells);
+    }
+
+    const ComponentCache& ModelCounter::cache() const {
+        return _cache;
+    }
+
+    unsigned long long ModelCounter::decisions() const {
+        return _decisions;
+    }
+}
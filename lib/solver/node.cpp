@@ -77,11 +77,11 @@ namespace minesweeper::solver {
         return numbers;
     }
 
-    Fraction Node::mine_probability() const {
+    double Node::mine_probability() const {
         return _mine_probability;
     }
 
-    void Node::set_mine_probability(Fraction mp) {
+    void Node::set_mine_probability(double mp) {
         if (mp < 0 || mp > 1) {
             throw std::invalid_argument("Mine probability cannot be less than 0 or greater than 1.");
         }
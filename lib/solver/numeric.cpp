@@ -0,0 +1,163 @@
+#include <solver/numeric.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace minesweeper::solver::numeric {
+    LogDouble::LogDouble(double value)
+        : _log { std::log(value) } {}
+
+    LogDouble LogDouble::from_log(double log) {
+        LogDouble result;
+        result._log = log;
+        return result;
+    }
+
+    double LogDouble::log() const {
+        return _log;
+    }
+
+    double LogDouble::value() const {
+        return std::exp(_log);
+    }
+
+    LogDouble& LogDouble::operator+=(const LogDouble& other) {
+        auto high = std::max(_log, other._log);
+        auto low = std::min(_log, other._log);
+        if (low != -INFINITY) {
+            high += std::log1p(std::exp(low - high));
+        }
+        _log = high;
+        return *this;
+    }
+
+    LogDouble& LogDouble::operator-=(const LogDouble& other) {
+        if (other._log >= _log) {
+            _log = -INFINITY;
+        } else if (other._log != -INFINITY) {
+            _log += std::log1p(-std::exp(other._log - _log));
+        }
+        return *this;
+    }
+
+    LogDouble& LogDouble::operator*=(const LogDouble& other) {
+        _log += other._log;
+        return *this;
+    }
+
+    LogDouble& LogDouble::operator/=(const LogDouble& other) {
+        _log -= other._log;
+        return *this;
+    }
+
+    /**
+     * Get log C(n, k).
+     */
+    static double log_binomial(unsigned int n, unsigned int k) {
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    // Float
+    Float::value_type Float::count(double count) {
+        return count;
+    }
+
+    std::vector<Float::value_type> Float::binomials(unsigned int n, const std::vector<unsigned int>& ks) {
+        std::vector<double> logs;
+        for (auto k : ks) {
+            logs.push_back(log_binomial(n, k));
+        }
+        auto max = logs.empty() ? 0.0 : *std::max_element(logs.begin(), logs.end());
+
+        std::vector<double> binomials;
+        for (auto log : logs) {
+            binomials.push_back(std::exp(log - max));
+        }
+        return binomials;
+    }
+
+    Float::value_type Float::from_double(double probability) {
+        return probability;
+    }
+
+    double Float::to_double(const value_type& value) {
+        return value;
+    }
+
+    // LogSpace
+    LogSpace::value_type LogSpace::count(double count) {
+        return count;
+    }
+
+    std::vector<LogSpace::value_type> LogSpace::binomials(unsigned int n, const std::vector<unsigned int>& ks) {
+        std::vector<LogDouble> binomials;
+        for (auto k : ks) {
+            binomials.push_back(LogDouble::from_log(log_binomial(n, k)));
+        }
+        return binomials;
+    }
+
+    LogSpace::value_type LogSpace::from_double(double probability) {
+        return probability;
+    }
+
+    double LogSpace::to_double(const value_type& value) {
+        return value.value();
+    }
+
+    // Exact
+    Exact::value_type Exact::count(double count) {
+        constexpr double exact_max = 1ULL << 62;
+        if (count >= exact_max) {
+            throw std::overflow_error("Solution count is too large for exact arithmetic");
+        }
+        auto whole = static_cast<long long>(count);
+        if (whole == count) {
+            return whole;
+        }
+        return from_double(count - whole) + whole;
+    }
+
+    std::vector<Exact::value_type> Exact::binomials(unsigned int n, const std::vector<unsigned int>& ks) {
+        std::vector<value_type> binomials;
+        for (auto k : ks) {
+            // Each partial product is itself a binomial coefficient, so the
+            // division is exact
+            long long binomial = 1;
+            for (auto i = 0U; i < std::min(k, n - k); i++) {
+                binomial = binomial * (n - i) / (i + 1);
+            }
+            binomials.push_back(binomial);
+        }
+        return binomials;
+    }
+
+    Exact::value_type Exact::from_double(double probability) {
+        // Continued fraction expansion, stopping before the denominator gets too big
+        constexpr long long max_denominator = 1 << 20;
+        auto x = probability;
+        long long h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+        for (auto i = 0; i < 64; i++) {
+            auto a = static_cast<long long>(std::floor(x));
+            auto k2 = a * k1 + k0;
+            if (k2 > max_denominator) {
+                break;
+            }
+            auto h2 = a * h1 + h0;
+            h0 = h1; h1 = h2;
+            k0 = k1; k1 = k2;
+
+            auto remainder = x - a;
+            if (remainder < 1e-12) {
+                break;
+            }
+            x = 1 / remainder;
+        }
+        return value_type(h1, k1);
+    }
+
+    double Exact::to_double(const value_type& value) {
+        return boost::rational_cast<double>(value);
+    }
+}
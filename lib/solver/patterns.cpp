@@ -0,0 +1,271 @@
+#include <solver/patterns.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        struct Header {
+            char magic[8];
+            std::uint64_t count;
+        };
+
+        struct RecordHeader {
+            std::uint32_t key_length;
+            std::uint32_t cell_count;
+        };
+
+        /**
+         * FNV-1a hash of a key, the same on every platform so that files
+         * can be shared.
+         */
+        std::uint64_t hash_key(const ComponentCache::Key& key) {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (auto value : key) {
+                hash = (hash ^ value) * 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        /**
+         * Round `offset` up to a multiple of 8, so that the doubles of a
+         * record are aligned.
+         */
+        std::uint64_t align(std::uint64_t offset) {
+            return (offset + 7) & ~std::uint64_t { 7 };
+        }
+    }
+
+    PatternDatabase::PatternDatabase(std::string path)
+        : _path { std::move(path) } {}
+
+    PatternDatabase::~PatternDatabase() {
+        if (_data) {
+            munmap(const_cast<unsigned char*>(_data), _size);
+        }
+    }
+
+    /**
+     * Map the database file into memory, if it exists.
+     */
+    void PatternDatabase::load() const {
+        std::call_once(_loaded, [this] {
+            auto fd = open(_path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+
+            struct stat status;
+            if (fstat(fd, &status) == 0 && status.st_size > 0) {
+                auto data = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (data != MAP_FAILED) {
+                    _data = static_cast<const unsigned char*>(data);
+                    _size = status.st_size;
+                }
+            }
+            close(fd);
+
+            if (!_data) {
+                return;
+            }
+            if (auto error = check()) {
+                munmap(const_cast<unsigned char*>(_data), _size);
+                _data = nullptr;
+                _size = 0;
+                throw std::runtime_error(error + (": " + _path));
+            }
+        });
+    }
+
+    /**
+     * Check that the mapped file is a pattern database whose index and
+     * records all lie within it, so that lookups never read past its end.
+     * 
+     * @return description of the first problem found, or nullptr if there
+     *      is none
+     */
+    const char* PatternDatabase::check() const {
+        if (_size < sizeof(Header) || std::memcmp(_data, magic, sizeof(magic)) != 0) {
+            return "Not a pattern database";
+        }
+
+        auto count = reinterpret_cast<const Header*>(_data)->count;
+        if (count > (_size - sizeof(Header)) / sizeof(IndexEntry)) {
+            return "Pattern database index is truncated";
+        }
+
+        auto records_offset = sizeof(Header) + count * sizeof(IndexEntry);
+        for (auto entry = index(); entry != index() + count; entry++) {
+            if (entry->offset < records_offset || entry->offset % 8 != 0 || entry->offset > _size - sizeof(RecordHeader)) {
+                return "Pattern database record is out of bounds";
+            }
+
+            // Key, then (n + 1)^2 aligned doubles of counts
+            auto record = reinterpret_cast<const RecordHeader*>(_data + entry->offset);
+            auto key_offset = entry->offset + sizeof(RecordHeader);
+            if (record->key_length > (_size - key_offset) / sizeof(std::uint32_t)) {
+                return "Pattern database record is truncated";
+            }
+            auto values_offset = align(key_offset + record->key_length * sizeof(std::uint32_t));
+            auto values = std::uint64_t { record->cell_count } + 1;
+            if (values_offset > _size || values > (_size - values_offset) / sizeof(double) / values) {
+                return "Pattern database record is truncated";
+            }
+        }
+        return nullptr;
+    }
+
+    const PatternDatabase::IndexEntry* PatternDatabase::index() const {
+        return reinterpret_cast<const IndexEntry*>(_data + sizeof(Header));
+    }
+
+    std::uint64_t PatternDatabase::pattern_count() const {
+        return _data ? reinterpret_cast<const Header*>(_data)->count : 0;
+    }
+
+    PatternDatabase::Canonical PatternDatabase::canonical(const Component& component) {
+        auto n = component.cells.size();
+        std::optional<Canonical> best;
+        for (auto symmetry = 0U; symmetry < 8; symmetry++) {
+            // Coordinates of each cell under the symmetry
+            std::vector<std::pair<long, long>> coords;
+            for (auto cell : component.cells) {
+                auto [x, y] = cell->coord();
+                long a = symmetry & 1 ? -static_cast<long>(x) : x;
+                long b = symmetry & 2 ? -static_cast<long>(y) : y;
+                coords.push_back(symmetry & 4 ? std::pair { b, a } : std::pair { a, b });
+            }
+
+            Canonical candidate { {}, std::vector<unsigned int>(n) };
+            std::iota(candidate.cells.begin(), candidate.cells.end(), 0);
+            std::sort(candidate.cells.begin(), candidate.cells.end(), [&coords](unsigned int i, unsigned int j) {
+                return coords[i] < coords[j];
+            });
+            candidate.key = ComponentCache::key(reorder(component, candidate));
+            if (!best || candidate.key < best->key) {
+                best = std::move(candidate);
+            }
+        }
+        return std::move(*best);
+    }
+
+    Component PatternDatabase::reorder(const Component& component, const Canonical& canonical) {
+        std::vector<unsigned int> position(canonical.cells.size());
+        Component reordered;
+        for (auto i = 0U; i < canonical.cells.size(); i++) {
+            position[canonical.cells[i]] = i;
+            reordered.cells.push_back(component.cells[canonical.cells[i]]);
+        }
+        for (auto &constraint : component.constraints) {
+            Constraint renumbered { {}, constraint.mines };
+            for (auto cell : constraint.cells) {
+                renumbered.cells.push_back(position[cell]);
+            }
+            reordered.constraints.push_back(std::move(renumbered));
+        }
+        return reordered;
+    }
+
+    std::optional<Counts> PatternDatabase::find(const Component& component) const {
+        load();
+        if (pattern_count() == 0) {
+            return std::nullopt;
+        }
+
+        auto canonical = PatternDatabase::canonical(component);
+        auto hash = hash_key(canonical.key);
+        auto begin = index(), end = index() + pattern_count();
+        auto entry = std::lower_bound(begin, end, hash, [](const IndexEntry& entry, std::uint64_t hash) {
+            return entry.hash < hash;
+        });
+        for (; entry != end && entry->hash == hash; entry++) {
+            auto record = reinterpret_cast<const RecordHeader*>(_data + entry->offset);
+            auto key = reinterpret_cast<const std::uint32_t*>(record + 1);
+            if (record->key_length != canonical.key.size() || !std::equal(key, key + record->key_length, canonical.key.begin())) {
+                continue;
+            }
+
+            // Counts are stored in canonical cell order
+            auto n = record->cell_count;
+            auto values = reinterpret_cast<const double*>(_data + align(entry->offset + sizeof(RecordHeader) + record->key_length * sizeof(std::uint32_t)));
+            Counts counts(n);
+            std::copy(values, values + n + 1, counts.solutions.begin());
+            for (auto i = 0U; i < n; i++) {
+                auto cell_mines = values + (n + 1) * (i + 1);
+                std::copy(cell_mines, cell_mines + n + 1, counts.cell_mines[canonical.cells[i]].begin());
+            }
+            return counts;
+        }
+        return std::nullopt;
+    }
+
+    std::size_t PatternDatabase::size() const {
+        load();
+        return pattern_count();
+    }
+
+    void PatternDatabase::write(const std::string& path, const std::vector<std::pair<ComponentCache::Key, Counts>>& patterns) {
+        std::vector<IndexEntry> entries;
+        std::vector<unsigned char> records;
+        auto records_offset = sizeof(Header) + patterns.size() * sizeof(IndexEntry);
+        auto append = [&records](const void* data, std::size_t size) {
+            auto bytes = static_cast<const unsigned char*>(data);
+            records.insert(records.end(), bytes, bytes + size);
+        };
+
+        for (auto &[key, counts] : patterns) {
+            auto offset = records_offset + records.size();
+            entries.push_back({ hash_key(key), offset });
+
+            std::uint32_t n = counts.cell_mines.size();
+            RecordHeader record { static_cast<std::uint32_t>(key.size()), n };
+            append(&record, sizeof(record));
+            for (std::uint32_t value : key) {
+                append(&value, sizeof(value));
+            }
+            records.resize(align(records_offset + records.size()) - records_offset);
+            append(counts.solutions.data(), counts.solutions.size() * sizeof(double));
+            for (auto &cell_mines : counts.cell_mines) {
+                append(cell_mines.data(), cell_mines.size() * sizeof(double));
+            }
+            records.resize(align(records_offset + records.size()) - records_offset);
+        }
+        std::sort(entries.begin(), entries.end(), [](const IndexEntry& a, const IndexEntry& b) {
+            return a.hash < b.hash;
+        });
+
+        // Written beside the old file then renamed over it, so processes
+        // with the old file mapped keep reading it rather than a truncated
+        // one
+        auto temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Could not write pattern database: " + path);
+        }
+        Header header;
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.count = patterns.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size());
+        file.close();
+        if (!file) {
+            std::filesystem::remove(temporary);
+            throw std::runtime_error("Could not write pattern database: " + path);
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary);
+            throw std::runtime_error("Could not write pattern database: " + path);
+        }
+    }
+}
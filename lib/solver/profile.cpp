@@ -0,0 +1,280 @@
+#include <solver/profile.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        using Profile = std::uint64_t;
+
+        // Bits per open constraint's mine count in a Profile
+        constexpr unsigned int slot_bits = 4;
+
+        /**
+         * Order the cells of a component so that cells sharing a constraint
+         * are close together, by a breadth first search from a cell with the
+         * fewest neighbours (Cuthill-McKee).
+         */
+        std::vector<unsigned int> sweep_order(const Component& component) {
+            auto n = component.cells.size();
+            std::vector<std::vector<unsigned int>> neighbours(n);
+            for (auto &constraint : component.constraints) {
+                for (auto a : constraint.cells) {
+                    for (auto b : constraint.cells) {
+                        if (a != b) {
+                            neighbours[a].push_back(b);
+                        }
+                    }
+                }
+            }
+            for (auto &cells : neighbours) {
+                std::sort(cells.begin(), cells.end());
+                cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            }
+            auto by_degree = [&neighbours](unsigned int a, unsigned int b) {
+                return std::pair { neighbours[a].size(), a } < std::pair { neighbours[b].size(), b };
+            };
+
+            std::vector<unsigned int> order;
+            std::vector<bool> visited(n, false);
+            while (order.size() < n) {
+                unsigned int start = n;
+                for (auto cell = 0U; cell < n; cell++) {
+                    if (!visited[cell] && (start == n || by_degree(cell, start))) {
+                        start = cell;
+                    }
+                }
+
+                std::queue<unsigned int> queue;
+                queue.push(start);
+                visited[start] = true;
+                while (!queue.empty()) {
+                    auto cell = queue.front();
+                    queue.pop();
+                    order.push_back(cell);
+
+                    auto next = neighbours[cell];
+                    std::sort(next.begin(), next.end(), by_degree);
+                    for (auto neighbour : next) {
+                        if (!visited[neighbour]) {
+                            visited[neighbour] = true;
+                            queue.push(neighbour);
+                        }
+                    }
+                }
+            }
+            return order;
+        }
+
+        /**
+         * Sweep of a component's cells in profile order, with what happens
+         * to each constraint at each step.
+         */
+        class Sweep {
+            // A constraint updated by a step, in the profile before and after
+            struct Update {
+                unsigned int constraint;
+                // slot of the constraint in the profile before the step, if open
+                int from;
+                // whether the step's cell is in the constraint
+                bool contains;
+                // cells of the constraint after the step
+                unsigned int after;
+            };
+
+            const Component& component;
+
+            // steps[p] updates the constraints open after position p, in
+            // the order of their slots
+            std::vector<std::vector<Update>> steps;
+
+            // closing[p] are the constraints whose last cell is at position p
+            std::vector<std::vector<Update>> closing;
+
+            static unsigned int slot(Profile profile, int from) {
+                return from < 0 ? 0 : (profile >> (slot_bits * from)) & ((1U << slot_bits) - 1);
+            }
+
+        public:
+            std::vector<unsigned int> order;
+
+            // largest number of constraints open at once
+            unsigned int width = 0;
+
+            // whether a constraint without cells needs mines
+            bool unsatisfiable = false;
+
+            Sweep(const Component& component)
+                : component { component },
+                  order { sweep_order(component) } {
+                auto n = order.size();
+                std::vector<unsigned int> position(n);
+                for (auto p = 0U; p < n; p++) {
+                    position[order[p]] = p;
+                }
+
+                std::vector<unsigned int> first, last;
+                std::vector<std::vector<unsigned int>> positions;
+                for (auto &constraint : component.constraints) {
+                    if (constraint.cells.empty()) {
+                        unsatisfiable |= constraint.mines > 0;
+                        first.push_back(n);
+                        last.push_back(0);
+                        positions.emplace_back();
+                        continue;
+                    }
+                    auto &cell_positions = positions.emplace_back();
+                    for (auto cell : constraint.cells) {
+                        cell_positions.push_back(position[cell]);
+                    }
+                    std::sort(cell_positions.begin(), cell_positions.end());
+                    first.push_back(cell_positions.front());
+                    last.push_back(cell_positions.back());
+                }
+
+                // Slots of the constraints open before each position
+                std::vector<int> slots(component.constraints.size(), -1);
+                steps.resize(n);
+                closing.resize(n);
+                for (auto p = 0U; p < n; p++) {
+                    std::vector<int> next_slots(component.constraints.size(), -1);
+                    for (auto c = 0U; c < component.constraints.size(); c++) {
+                        if (first[c] > p || last[c] < p) {
+                            continue;
+                        }
+                        auto &cell_positions = positions[c];
+                        auto contains = std::binary_search(cell_positions.begin(), cell_positions.end(), p);
+                        auto after = static_cast<unsigned int>(cell_positions.end() - std::upper_bound(cell_positions.begin(), cell_positions.end(), p));
+                        Update update { c, slots[c], contains, after };
+                        if (last[c] == p) {
+                            closing[p].push_back(update);
+                        } else {
+                            next_slots[c] = steps[p].size();
+                            steps[p].push_back(update);
+                        }
+                    }
+                    width = std::max(width, static_cast<unsigned int>(steps[p].size()));
+                    slots = std::move(next_slots);
+                }
+            }
+
+            /**
+             * Get the profile after giving the cell at position `p` the
+             * value `value`, or no value if that breaks a constraint.
+             */
+            std::optional<Profile> step(unsigned int p, Profile profile, unsigned int value) const {
+                for (auto &update : closing[p]) {
+                    auto mines = slot(profile, update.from) + (update.contains ? value : 0);
+                    if (mines != component.constraints[update.constraint].mines) {
+                        return std::nullopt;
+                    }
+                }
+
+                Profile next = 0;
+                for (auto s = 0U; s < steps[p].size(); s++) {
+                    auto &update = steps[p][s];
+                    auto mines = slot(profile, update.from) + (update.contains ? value : 0);
+                    auto needed = component.constraints[update.constraint].mines;
+                    if (mines > needed || mines + update.after < needed) {
+                        return std::nullopt;
+                    }
+                    next |= static_cast<Profile>(mines) << (slot_bits * s);
+                }
+                return next;
+            }
+        };
+
+        using Layer = std::unordered_map<Profile, std::vector<double>>;
+
+        /**
+         * Add `polynomial`, shifted up by `shift` mines, to `total`.
+         */
+        void add_shifted(std::vector<double>& total, const std::vector<double>& polynomial, unsigned int shift) {
+            for (auto k = 0U; k < polynomial.size() && k + shift < total.size(); k++) {
+                total[k + shift] += polynomial[k];
+            }
+        }
+    }
+
+    unsigned int ProfileCounter::width(const Component& component) {
+        return Sweep(component).width;
+    }
+
+    Counts ProfileCounter::count(const Component& component) {
+        Sweep sweep(component);
+        if (sweep.width > max_width) {
+            throw std::invalid_argument("Component is too wide to count by profile");
+        }
+
+        auto n = static_cast<unsigned int>(component.cells.size());
+        Counts counts(n);
+        if (sweep.unsatisfiable) {
+            return counts;
+        }
+
+        // forward[p] maps each profile before position p to the number of
+        // ways to reach it, by mines used so far
+        std::vector<Layer> forward(n + 1);
+        forward[0][0] = { 1 };
+        for (auto p = 0U; p < n; p++) {
+            for (auto &[profile, polynomial] : forward[p]) {
+                for (auto value = 0U; value <= 1; value++) {
+                    auto next = sweep.step(p, profile, value);
+                    if (!next) {
+                        continue;
+                    }
+                    auto &total = forward[p + 1][*next];
+                    total.resize(p + 2);
+                    add_shifted(total, polynomial, value);
+                }
+            }
+        }
+
+        auto solutions = forward[n].find(0);
+        if (solutions == forward[n].end()) {
+            return counts;
+        }
+        counts.solutions = solutions->second;
+
+        // backward maps each profile after position p to the number of ways
+        // to finish from it, by mines used from there on
+        Layer backward { { 0, { 1 } } };
+        for (auto p = n; p-- > 0;) {
+            auto cell = sweep.order[p];
+            Layer previous;
+            for (auto &[profile, reached] : forward[p]) {
+                auto &total = previous[profile];
+                total.assign(n - p + 1, 0.0);
+                for (auto value = 0U; value <= 1; value++) {
+                    auto next = sweep.step(p, profile, value);
+                    if (!next) {
+                        continue;
+                    }
+                    auto remaining = backward.find(*next);
+                    if (remaining == backward.end()) {
+                        continue;
+                    }
+                    add_shifted(total, remaining->second, value);
+
+                    // Solutions through this profile with the cell a mine
+                    if (value == 1) {
+                        auto &cell_mines = counts.cell_mines[cell];
+                        for (auto a = 0U; a < reached.size(); a++) {
+                            if (reached[a] == 0) {
+                                continue;
+                            }
+                            for (auto b = 0U; b < remaining->second.size() && a + b + 1 <= n; b++) {
+                                cell_mines[a + b + 1] += reached[a] * remaining->second[b];
+                            }
+                        }
+                    }
+                }
+            }
+            backward = std::move(previous);
+        }
+        return counts;
+    }
+}
@@ -0,0 +1,176 @@
+#include <solver/renderer.hpp>
+
+namespace minesweeper::solver {
+    namespace {
+        constexpr const char* mode_label = "Solve Mode in Use: ";
+
+        // Rows of the screen above the grid: the mode and a blank line
+        constexpr unsigned int header_rows = 2;
+
+        /**
+         * Append the sequence which moves the cursor to a 1-based row and
+         * column.
+         */
+        void move_to(std::string& out, unsigned int row, unsigned int column) {
+            out += "\x1b[";
+            out += std::to_string(row);
+            out += ';';
+            out += std::to_string(column);
+            out += 'H';
+        }
+
+        /**
+         * Append a tile as its glyph and a space, highlighted if selected.
+         */
+        void append_tile(std::string& out, char glyph, bool selected) {
+            if (selected) {
+                out += "\x1b[32m"; // Green
+            }
+            out += glyph;
+            out += ' ';
+            if (selected) {
+                out += "\x1b[0m"; // Reset color
+            }
+        }
+    }
+
+    // Frame implementation
+    Frame::Frame(unsigned int width, unsigned int height)
+        : _width { width },
+          _height { height },
+          _glyphs(width * height, 'O') {}
+
+    unsigned int Frame::width() const {
+        return _width;
+    }
+
+    unsigned int Frame::height() const {
+        return _height;
+    }
+
+    const std::string& Frame::mode() const {
+        return _mode;
+    }
+
+    void Frame::set_mode(const char* mode) {
+        _mode = mode;
+    }
+
+    char Frame::glyph(unsigned int x, unsigned int y) const {
+        return _glyphs[y * _width + x];
+    }
+
+    void Frame::set(unsigned int x, unsigned int y, Tile value) {
+        char glyph;
+        switch (value) {
+            case Tile::Mine:
+                glyph = '*';
+                break;
+            case Tile::Flag:
+                glyph = 'f';
+                break;
+            case Tile::Covered:
+                glyph = 'O';
+                break;
+            case 0:
+                glyph = ' ';
+                break;
+            default:
+                glyph = static_cast<char>('0' + value);
+        }
+        _glyphs[y * _width + x] = glyph;
+    }
+
+    bool Frame::selected(unsigned int x, unsigned int y) const {
+        return _selected == static_cast<int>(y * _width + x);
+    }
+
+    void Frame::set_selected(unsigned int x, unsigned int y) {
+        _selected = y * _width + x;
+    }
+
+
+    // FrameRenderer implementation
+    FrameRenderer::FrameRenderer(std::ostream& out, std::chrono::milliseconds frame_interval)
+        : _out { &out },
+          _frame_interval { frame_interval } {}
+
+    bool FrameRenderer::render(const Frame& frame) {
+        auto now = Clock::now();
+        if (_last_draw && now - *_last_draw < _frame_interval) {
+            _pending = frame;
+            _has_pending = true;
+            return false;
+        }
+        draw(frame);
+        _last_draw = now;
+        return true;
+    }
+
+    void FrameRenderer::flush() {
+        if (_has_pending) {
+            draw(_pending);
+            _last_draw = Clock::now();
+        }
+    }
+
+    /**
+     * Write the changes to `frame` in one call, and remember it as shown.
+     */
+    void FrameRenderer::draw(const Frame& frame) {
+        build(frame, _buffer);
+        if (!_buffer.empty()) {
+            _out->write(_buffer.data(), _buffer.size());
+            _out->flush();
+        }
+        _shown = frame;
+        _has_pending = false;
+    }
+
+    std::string FrameRenderer::diff(const Frame& frame) const {
+        std::string out;
+        build(frame, out);
+        return out;
+    }
+
+    /**
+     * Build the output of `diff` into `out`, reusing its memory from frame
+     * to frame.
+     */
+    void FrameRenderer::build(const Frame& frame, std::string& out) const {
+        out.clear();
+        auto redraw = !_last_draw || frame.width() != _shown.width() || frame.height() != _shown.height();
+        if (redraw) {
+            out += "\x1b[2J"; // Clear screen
+        }
+        if (redraw || frame.mode() != _shown.mode()) {
+            move_to(out, 1, 1);
+            out += mode_label;
+            out += frame.mode();
+            out += "\x1b[K"; // Clear the rest of the line
+        }
+
+        // Position the cursor only where a tile isn't just right of the
+        // last tile written
+        std::optional<std::pair<unsigned int, unsigned int>> cursor;
+        for (auto y = 0U; y < frame.height(); y++) {
+            for (auto x = 0U; x < frame.width(); x++) {
+                auto glyph = frame.glyph(x, y);
+                auto selected = frame.selected(x, y);
+                if (!redraw && glyph == _shown.glyph(x, y) && selected == _shown.selected(x, y)) {
+                    continue;
+                }
+                if (cursor != std::pair(x, y)) {
+                    move_to(out, header_rows + y + 1, 2 * x + 1);
+                }
+                append_tile(out, glyph, selected);
+                cursor = std::pair(x + 1, y);
+            }
+        }
+
+        // Leave the cursor below the grid, for whatever is printed next
+        if (!out.empty()) {
+            move_to(out, header_rows + frame.height() + 2, 1);
+        }
+    }
+}
@@ -0,0 +1,455 @@
+#include <solver/sampler.hpp>
+#include <solver/enumerator.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+
+namespace minesweeper::solver::frontier {
+    namespace {
+        /**
+         * One Markov chain over the configurations of every component of the
+         * frontier at once, since the global mine count couples them.
+         */
+        class Chain {
+            // Blocks larger than this aren't worth enumerating
+            static constexpr unsigned int max_block_cells = 12;
+
+            std::vector<Constraint> constraints;
+            std::vector<std::vector<unsigned int>> cell_constraints;
+            unsigned int interior_cells, mines_left;
+
+            // Cells redrawn together by a step, and the constraints they touch
+            struct Block {
+                // constraint neighbouring the first one the block was made of
+                unsigned int second;
+
+                std::vector<unsigned int> cells;
+
+                // constraints with cells in the block
+                std::vector<unsigned int> touched;
+
+                // bits of the block's cells in each touched constraint
+                std::vector<std::uint32_t> masks;
+
+                // cells of each touched constraint outside the block
+                std::vector<std::vector<unsigned int>> outside;
+            };
+
+            // blocks[c] has a Block for every neighbour of constraint c
+            std::vector<std::vector<Block>> blocks;
+
+            // log_weights[k] is the log weight of k mines on the frontier
+            std::vector<double> log_weights;
+
+            std::vector<bool> values;
+            unsigned int mines = 0;
+
+            std::mt19937_64 rng;
+
+            // scratch space of `step`
+            std::vector<int> needed;
+            std::vector<std::uint32_t> assignments;
+            std::vector<double> weights;
+
+            /**
+             * Make the Block of constraint `first` and its neighbour `second`.
+             */
+            Block make_block(unsigned int first, unsigned int second) const {
+                Block block;
+                block.second = second;
+                block.cells = constraints[first].cells;
+                for (auto cell : constraints[second].cells) {
+                    if (std::find(block.cells.begin(), block.cells.end(), cell) == block.cells.end() && block.cells.size() < max_block_cells) {
+                        block.cells.push_back(cell);
+                    }
+                }
+
+                for (auto cell : block.cells) {
+                    for (auto c : cell_constraints[cell]) {
+                        if (std::find(block.touched.begin(), block.touched.end(), c) == block.touched.end()) {
+                            block.touched.push_back(c);
+                        }
+                    }
+                }
+                for (auto c : block.touched) {
+                    std::uint32_t mask = 0;
+                    auto &outside = block.outside.emplace_back();
+                    for (auto cell : constraints[c].cells) {
+                        auto position = std::find(block.cells.begin(), block.cells.end(), cell) - block.cells.begin();
+                        if (position < static_cast<long>(block.cells.size())) {
+                            mask |= 1U << position;
+                        } else {
+                            outside.push_back(cell);
+                        }
+                    }
+                    block.masks.push_back(mask);
+                }
+                return block;
+            }
+
+        public:
+            // sums of each cell's values over the samples
+            std::vector<double> cell_sums;
+
+            // sums of the interior probability and its square
+            double interior_sum = 0, interior_squared_sum = 0;
+
+            unsigned long samples = 0;
+
+            // whether configurations are weighted by the placements of the
+            // remaining mines, or all count the same
+            bool weighted;
+
+            Chain(const std::vector<Component>& components, unsigned int interior_cells, unsigned int mines_left, bool weighted, std::seed_seq& seed)
+                : interior_cells { interior_cells },
+                  mines_left { mines_left },
+                  rng { seed },
+                  weighted { weighted } {
+                // Number every cell of the frontier, starting each component
+                // from a random solution
+                for (auto &component : components) {
+                    auto offset = static_cast<unsigned int>(values.size());
+                    auto solution = random_solution(component, rng);
+                    if (!solution) {
+                        throw std::invalid_argument("Frontier component has no solution");
+                    }
+                    values.insert(values.end(), solution->begin(), solution->end());
+
+                    for (auto &constraint : component.constraints) {
+                        Constraint shifted { {}, constraint.mines };
+                        for (auto cell : constraint.cells) {
+                            shifted.cells.push_back(cell + offset);
+                        }
+                        constraints.push_back(std::move(shifted));
+                    }
+                }
+
+                cell_constraints.resize(values.size());
+                for (auto c = 0U; c < constraints.size(); c++) {
+                    for (auto cell : constraints[c].cells) {
+                        cell_constraints[cell].push_back(c);
+                    }
+                }
+                mines = std::count(values.begin(), values.end(), true);
+                cell_sums.resize(values.size());
+
+                blocks.resize(constraints.size());
+                for (auto c = 0U; c < constraints.size(); c++) {
+                    for (auto cell : constraints[c].cells) {
+                        for (auto neighbour : cell_constraints[cell]) {
+                            auto &existing = blocks[c];
+                            if (std::none_of(existing.begin(), existing.end(), [neighbour](const Block& block) { return block.second == neighbour; })) {
+                                existing.push_back(make_block(c, neighbour));
+                            }
+                        }
+                    }
+                }
+                for (auto k = 0L; k <= static_cast<long>(values.size()); k++) {
+                    log_weights.push_back(log_weight(k));
+                }
+            }
+
+            /**
+             * Check whether `frontier_mines` leaves a number of mines the
+             * interior can hold.
+             */
+            bool feasible(long frontier_mines) const {
+                auto remaining = static_cast<long>(mines_left) - frontier_mines;
+                return remaining >= 0 && remaining <= static_cast<long>(interior_cells);
+            }
+
+            /**
+             * Get the log of the number of ways to place the mines left by
+             * `frontier_mines` in the interior. Infeasible counts are
+             * penalised by their distance from feasibility instead, so that
+             * a chain starting from one can still find its way back.
+             * Unweighted chains weight every configuration equally.
+             */
+            double log_weight(long frontier_mines) const {
+                if (!weighted) {
+                    return 0;
+                }
+                auto remaining = static_cast<long>(mines_left) - frontier_mines;
+                if (remaining < 0) {
+                    return -1000.0 * -remaining;
+                }
+                if (remaining > static_cast<long>(interior_cells)) {
+                    return -1000.0 * (remaining - static_cast<long>(interior_cells));
+                }
+                return std::lgamma(interior_cells + 1.0) - std::lgamma(remaining + 1.0) - std::lgamma(interior_cells - remaining + 1.0);
+            }
+
+            /**
+             * Collect every assignment of the block's cells from `position`
+             * on, extending `assignment`, which gives each constraint with
+             * cells in `masks` its needed number of mines.
+             */
+            static void satisfying(const std::vector<std::uint32_t>& masks, const std::vector<int>& needed, unsigned int size, unsigned int position, std::uint32_t assignment, std::vector<std::uint32_t>& assignments) {
+                if (position == size) {
+                    assignments.push_back(assignment);
+                    return;
+                }
+
+                std::uint32_t assigned = (2U << position) - 1;
+                for (std::uint32_t value = 0; value <= 1; value++) {
+                    auto next = assignment | (value << position);
+                    auto possible = true;
+                    for (auto t = 0U; t < masks.size() && possible; t++) {
+                        auto placed = std::popcount(next & masks[t]);
+                        auto unassigned = std::popcount(masks[t] & ~assigned);
+                        possible = placed <= needed[t] && placed + unassigned >= needed[t];
+                    }
+                    if (possible) {
+                        satisfying(masks, needed, size, position + 1, next, assignments);
+                    }
+                }
+            }
+
+            /**
+             * Redraw the cells of a random constraint and one of its
+             * neighbours from every assignment satisfying their constraints.
+             */
+            void step() {
+                if (constraints.empty()) {
+                    return;
+                }
+
+                auto first = std::uniform_int_distribution<std::size_t>(0, constraints.size() - 1)(rng);
+                auto &first_cells = constraints[first].cells;
+                auto pivot = first_cells[std::uniform_int_distribution<std::size_t>(0, first_cells.size() - 1)(rng)];
+                auto &neighbours = cell_constraints[pivot];
+                auto second = neighbours[std::uniform_int_distribution<std::size_t>(0, neighbours.size() - 1)(rng)];
+                auto &block = *std::find_if(blocks[first].begin(), blocks[first].end(), [second](const Block& block) {
+                    return block.second == second;
+                });
+
+                // Each constraint touching the block needs the mines its
+                // cells outside the block don't have
+                needed.clear();
+                for (auto t = 0U; t < block.touched.size(); t++) {
+                    int need = constraints[block.touched[t]].mines;
+                    for (auto cell : block.outside[t]) {
+                        need -= values[cell];
+                    }
+                    needed.push_back(need);
+                }
+
+                unsigned int block_mines = 0;
+                for (auto cell : block.cells) {
+                    block_mines += values[cell];
+                }
+                auto outside_mines = mines - block_mines;
+
+                // Heat bath over the satisfying assignments of the block
+                assignments.clear();
+                satisfying(block.masks, needed, block.cells.size(), 0, 0, assignments);
+                if (assignments.empty()) {
+                    return;
+                }
+
+                auto max = -std::numeric_limits<double>::infinity();
+                for (auto assignment : assignments) {
+                    max = std::max(max, log_weights[outside_mines + std::popcount(assignment)]);
+                }
+                weights.clear();
+                double total = 0;
+                for (auto assignment : assignments) {
+                    total += std::exp(log_weights[outside_mines + std::popcount(assignment)] - max);
+                    weights.push_back(total);
+                }
+                auto chosen = std::uniform_real_distribution<double>(0, total)(rng);
+                auto index = std::upper_bound(weights.begin(), weights.end(), chosen) - weights.begin();
+                auto assignment = assignments[std::min<std::size_t>(index, assignments.size() - 1)];
+
+                mines = outside_mines;
+                for (auto i = 0U; i < block.cells.size(); i++) {
+                    values[block.cells[i]] = (assignment >> i) & 1;
+                    mines += values[block.cells[i]];
+                }
+            }
+
+            /**
+             * Make one step per constraint.
+             */
+            void sweep() {
+                for (auto s = 0U; s < std::max<std::size_t>(constraints.size(), 1); s++) {
+                    step();
+                }
+            }
+
+            /**
+             * Get the current configuration, unless it leaves the interior an
+             * impossible number of mines.
+             */
+            std::optional<Configuration> configuration() const {
+                if (weighted && !feasible(mines)) {
+                    return std::nullopt;
+                }
+                auto interior = std::clamp(static_cast<long>(mines_left) - static_cast<long>(mines), 0L, static_cast<long>(interior_cells));
+                return Configuration { values, static_cast<unsigned int>(interior) };
+            }
+
+            /**
+             * Add the current configuration to the sums, unless it leaves the
+             * interior an impossible number of mines.
+             */
+            void record() {
+                if (weighted && !feasible(mines)) {
+                    return;
+                }
+                samples++;
+                for (auto i = 0U; i < values.size(); i++) {
+                    cell_sums[i] += values[i];
+                }
+                auto interior = interior_cells > 0 ? (static_cast<double>(mines_left) - mines) / interior_cells : 0.0;
+                interior_sum += interior;
+                interior_squared_sum += interior * interior;
+            }
+        };
+
+        /**
+         * Gelman-Rubin potential scale reduction factor of one quantity,
+         * from its sum and sum of squares in each chain.
+         */
+        double r_hat(const std::vector<double>& sums, const std::vector<double>& squared_sums, const std::vector<unsigned long>& samples) {
+            auto m = static_cast<double>(sums.size());
+            double n = 0, grand_mean = 0;
+            for (auto j = 0U; j < sums.size(); j++) {
+                if (samples[j] < 2) {
+                    return std::numeric_limits<double>::infinity();
+                }
+                n += samples[j] / m;
+                grand_mean += sums[j] / samples[j] / m;
+            }
+
+            double between = 0, within = 0;
+            for (auto j = 0U; j < sums.size(); j++) {
+                auto mean = sums[j] / samples[j];
+                between += (mean - grand_mean) * (mean - grand_mean) * n / (m - 1);
+                within += (squared_sums[j] - samples[j] * mean * mean) / (samples[j] - 1) / m;
+            }
+            if (within <= 0) {
+                // Every chain stayed put: fine if they agree
+                return between <= 0 ? 1 : std::numeric_limits<double>::infinity();
+            }
+            auto variance = (n - 1) / n * within + between / n;
+            return std::sqrt(variance / within);
+        }
+    }
+
+    bool Diagnostics::converged() const {
+        return max_r_hat < 1.1;
+    }
+
+    MarkovChainSampler::MarkovChainSampler(unsigned long seed, unsigned long samples, unsigned int chains)
+        : _seed { seed },
+          _samples { samples },
+          _chains { chains } {
+        if (chains < 2) {
+            throw std::invalid_argument("Convergence can't be diagnosed with fewer than 2 chains");
+        }
+        if (samples < 2) {
+            throw std::invalid_argument("Convergence can't be diagnosed with fewer than 2 samples");
+        }
+    }
+
+    Probabilities MarkovChainSampler::sample(const std::vector<Component>& components, unsigned int interior_cells, unsigned int mines_left) {
+        // Like `combine`, ignore the mines left if no configuration of the
+        // frontier leaves the interior a possible number of them
+        std::vector<Chain> chains;
+        unsigned long total_samples = 0;
+        for (auto weighted : { true, false }) {
+            chains.clear();
+            for (auto c = 0U; c < _chains; c++) {
+                std::seed_seq seed { static_cast<std::uint32_t>(_seed), static_cast<std::uint32_t>(_seed >> 32), c };
+                chains.emplace_back(components, interior_cells, mines_left, weighted, seed);
+            }
+
+            total_samples = 0;
+            for (auto &chain : chains) {
+                for (auto s = 0UL; s < _samples / 2; s++) {
+                    chain.sweep();
+                }
+                for (auto s = 0UL; s < _samples; s++) {
+                    chain.sweep();
+                    chain.record();
+                }
+                total_samples += chain.samples;
+            }
+            if (total_samples > 0) {
+                break;
+            }
+        }
+
+        std::vector<unsigned long> samples;
+        for (auto &chain : chains) {
+            samples.push_back(chain.samples);
+        }
+
+        Probabilities probabilities { {}, 0, chains.front().weighted };
+        _diagnostics = { total_samples / _chains, 1 };
+        auto cell = 0U;
+        for (auto &component : components) {
+            auto &probability = probabilities.cells.emplace_back();
+            for (auto i = 0U; i < component.cells.size(); i++, cell++) {
+                // Cell values are 0 or 1, so their squares sum to their sum
+                std::vector<double> sums;
+                double sum = 0;
+                for (auto &chain : chains) {
+                    sums.push_back(chain.cell_sums[cell]);
+                    sum += chain.cell_sums[cell];
+                }
+                probability.push_back(total_samples > 0 ? sum / total_samples : 0);
+                _diagnostics.max_r_hat = std::max(_diagnostics.max_r_hat, r_hat(sums, sums, samples));
+            }
+        }
+
+        std::vector<double> interior_sums, interior_squared_sums;
+        for (auto &chain : chains) {
+            interior_sums.push_back(chain.interior_sum);
+            interior_squared_sums.push_back(chain.interior_squared_sum);
+            probabilities.interior += chain.interior_sum;
+        }
+        if (total_samples > 0) {
+            probabilities.interior = std::clamp(probabilities.interior / total_samples, 0.0, 1.0);
+        }
+        if (interior_cells > 0) {
+            _diagnostics.max_r_hat = std::max(_diagnostics.max_r_hat, r_hat(interior_sums, interior_squared_sums, samples));
+        }
+        return probabilities;
+    }
+
+    std::vector<Configuration> MarkovChainSampler::configurations(const std::vector<Component>& components, unsigned int interior_cells, unsigned int mines_left, unsigned long count) {
+        // Like `sample`, ignore the mines left if no configuration of the
+        // frontier leaves the interior a possible number of them
+        std::vector<Configuration> configurations;
+        for (auto weighted : { true, false }) {
+            for (auto c = 0U; c < _chains; c++) {
+                std::seed_seq seed { static_cast<std::uint32_t>(_seed), static_cast<std::uint32_t>(_seed >> 32), c };
+                Chain chain(components, interior_cells, mines_left, weighted, seed);
+                for (auto s = 0UL; s < _samples / 2; s++) {
+                    chain.sweep();
+                }
+                auto share = count * (c + 1) / _chains - count * c / _chains;
+                for (auto s = 0UL; s < share; s++) {
+                    chain.sweep();
+                    if (auto configuration = chain.configuration()) {
+                        configurations.push_back(std::move(*configuration));
+                    }
+                }
+            }
+            if (!configurations.empty()) {
+                break;
+            }
+        }
+        return configurations;
+    }
+
+    const Diagnostics& MarkovChainSampler::diagnostics() const {
+        return _diagnostics;
+    }
+}
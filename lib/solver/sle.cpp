@@ -1,8 +1,199 @@
 #include <solver/sle.hpp>
 #include <queue>
 #include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <bit>
+#include <cstdlib>
 
 namespace minesweeper::solver::sle {
+    // EvaluationPlan implementation
+    const std::vector<Node*>& EvaluationPlan::variables() const {
+        return _variables;
+    }
+
+    unsigned int EvaluationPlan::input_count() const {
+        return _input_count;
+    }
+
+    void EvaluationPlan::evaluate(std::vector<Fraction>& values) const {
+        if (values.size() != _variables.size()) {
+            throw std::invalid_argument("Expected one value per variable slot");
+        }
+
+        for (auto &step : _steps) {
+            auto total = step.total;
+            for (auto i = step.terms_begin; i < step.terms_end; i++) {
+                total -= _terms[i].coefficient * values[_terms[i].slot];
+            }
+            values[step.target] = total / step.pivot;
+        }
+    }
+
+
+    // BatchEvaluator implementation
+    // Lanes in which lane input i is 1, i.e. lane index has bit i set
+    static constexpr std::uint64_t lane_input_patterns[] = {
+        0xAAAAAAAAAAAAAAAA,
+        0xCCCCCCCCCCCCCCCC,
+        0xF0F0F0F0F0F0F0F0,
+        0xFF00FF00FF00FF00,
+        0xFFFF0000FFFF0000,
+        0xFFFFFFFF00000000
+    };
+
+    BatchEvaluator::BatchEvaluator(const EvaluationPlan& plan)
+        : _variable_count { static_cast<unsigned int>(plan._variables.size()) },
+          _input_count { plan._input_count } {
+        _lane_inputs = std::min(_input_count, static_cast<unsigned int>(std::size(lane_input_patterns)));
+        auto lanes_used = 1U << _lane_inputs;
+        _lane_mask = lanes_used == lanes ? ~std::uint64_t{0} : (std::uint64_t{1} << lanes_used) - 1;
+
+        /* Express every variable as an affine function of the inputs.
+           forms[slot][i] is the coefficient of input i, and
+           forms[slot][_input_count] is the constant */
+        std::vector<std::vector<Fraction>> forms(_variable_count, std::vector<Fraction>(_input_count + 1));
+        for (auto i = 0U; i < _input_count; i++) {
+            forms[i][i] = 1;
+        }
+        for (auto &step : plan._steps) {
+            auto &form = forms[step.target];
+            form[_input_count] = step.total;
+            for (auto t = step.terms_begin; t < step.terms_end; t++) {
+                auto &term = plan._terms[t];
+                for (auto i = 0U; i <= _input_count; i++) {
+                    form[i] -= term.coefficient * forms[term.slot][i];
+                }
+            }
+            for (auto &coeff : form) {
+                coeff /= step.pivot;
+            }
+        }
+
+        // Scale each dependent variable's form to integer coefficients.
+        // Every scaled coefficient is at most max_coefficient in size and
+        // a row's sizes sum to at most max_row, so that the partial sums
+        // of evaluate can't overflow
+        constexpr std::int64_t max_denominator = std::int64_t{1} << 40;
+        constexpr std::int64_t max_coefficient = std::int64_t{1} << 40;
+        constexpr std::int64_t max_row = std::int64_t{1} << 62;
+        for (auto &step : plan._steps) {
+            auto &form = forms[step.target];
+
+            std::int64_t denominator = 1;
+            for (auto &coeff : form) {
+                denominator = std::lcm(denominator, static_cast<std::int64_t>(coeff.denominator()));
+                if (denominator > max_denominator) {
+                    throw std::overflow_error("Plan coefficients are too large to evaluate bit-sliced");
+                }
+            }
+
+            Dependent dependent { step.target, 0, denominator, {}, {} };
+            auto row = denominator;
+            for (auto i = 0U; i <= _input_count; i++) {
+                std::int64_t numerator = form[i].numerator();
+                auto multiplier = denominator / form[i].denominator();
+                if (std::abs(numerator) > max_coefficient / multiplier) {
+                    throw std::overflow_error("Plan coefficients are too large to evaluate bit-sliced");
+                }
+                auto scaled = numerator * multiplier;
+                row += std::abs(scaled);
+                if (row > max_row) {
+                    throw std::overflow_error("Plan coefficients are too large to evaluate bit-sliced");
+                }
+                if (i == _input_count) {
+                    dependent.constant = scaled;
+                } else {
+                    dependent.coefficients.push_back(scaled);
+                }
+            }
+
+            // Group lanes by the partial sum of the lane inputs
+            std::map<std::int64_t, std::uint64_t> lane_values;
+            for (auto lane = 0U; lane < lanes_used; lane++) {
+                std::int64_t sum = 0;
+                for (auto i = 0U; i < _lane_inputs; i++) {
+                    if ((lane >> i) & 1) {
+                        sum += dependent.coefficients[i];
+                    }
+                }
+                lane_values[sum] |= std::uint64_t{1} << lane;
+            }
+            dependent.lane_values.assign(lane_values.begin(), lane_values.end());
+
+            _dependents.push_back(std::move(dependent));
+        }
+    }
+
+    /**
+     * Get the lanes in which the lane inputs sum to `value`.
+     * 
+     * @param lane_values sorted list of partial sums and their lanes
+     * @param value partial sum to find
+     * 
+     * @return mask of lanes with the partial sum `value`
+     */
+    std::uint64_t BatchEvaluator::lanes_with(const LaneValues& lane_values, std::int64_t value) {
+        auto it = std::lower_bound(lane_values.begin(), lane_values.end(), value, [](auto &entry, auto value) {
+            return entry.first < value;
+        });
+        return it != lane_values.end() && it->first == value ? it->second : 0;
+    }
+
+    unsigned int BatchEvaluator::lane_inputs() const {
+        return _lane_inputs;
+    }
+
+    unsigned int BatchEvaluator::batch_inputs() const {
+        return _input_count - _lane_inputs;
+    }
+
+    std::uint64_t BatchEvaluator::evaluate(const std::vector<std::uint8_t>& batch_values, std::vector<std::uint64_t>& mine_counts) const {
+        if (batch_values.size() != batch_inputs() || mine_counts.size() != _variable_count) {
+            throw std::invalid_argument("Batch values or mine counts have the wrong size");
+        }
+
+        // Partial sum of the batch inputs, which is the same for every lane
+        auto batch_sum = [&](const Dependent& dependent) {
+            auto sum = dependent.constant;
+            for (auto i = 0U; i < batch_values.size(); i++) {
+                if (batch_values[i]) {
+                    sum += dependent.coefficients[_lane_inputs + i];
+                }
+            }
+            return sum;
+        };
+
+        // A lane is valid if every dependent variable is 0 or 1
+        auto valid = _lane_mask;
+        for (auto &dependent : _dependents) {
+            auto sum = batch_sum(dependent);
+            valid &= lanes_with(dependent.lane_values, -sum)
+                | lanes_with(dependent.lane_values, dependent.denominator - sum);
+            if (valid == 0) {
+                return 0;
+            }
+        }
+
+        auto valid_count = std::popcount(valid);
+        for (auto i = 0U; i < _lane_inputs; i++) {
+            mine_counts[i] += std::popcount(valid & lane_input_patterns[i]);
+        }
+        for (auto i = 0U; i < batch_values.size(); i++) {
+            if (batch_values[i]) {
+                mine_counts[_lane_inputs + i] += valid_count;
+            }
+        }
+        for (auto &dependent : _dependents) {
+            auto sum = batch_sum(dependent);
+            mine_counts[dependent.slot] += std::popcount(valid & lanes_with(dependent.lane_values, dependent.denominator - sum));
+        }
+        return valid_count;
+    }
+
+
     // SystemOfLinearEquations implementation
     // private methods:
 
@@ -116,7 +307,9 @@ namespace minesweeper::solver::sle {
         // In row echelon form, the 1st variable in each equation is dependent
         auto vars = variables();
         for (auto &[coefficients, total] : _equations) {
-            vars.erase(coefficients.begin()->first);
+            if (!coefficients.empty()) {
+                vars.erase(coefficients.begin()->first);
+            }
         }
         return vars;
     }
@@ -172,6 +365,76 @@ namespace minesweeper::solver::sle {
         }
     }
 
+    EvaluationPlan SystemOfLinearEquations::compile(const std::set<Node*>& inputs) const {
+        EvaluationPlan plan;
+
+        // Independent variables take the first slots, dependent variables the rest
+        std::unordered_map<Node*, unsigned int> slots;
+        for (auto var : inputs) {
+            slots.insert({var, plan._variables.size()});
+            plan._variables.push_back(var);
+        }
+        plan._input_count = plan._variables.size();
+        for (auto var : variables()) {
+            if (slots.insert({var, plan._variables.size()}).second) {
+                plan._variables.push_back(var);
+            }
+        }
+
+        // Replay the order `evaluate` would solve the equations in
+        std::vector<bool> known(plan._variables.size(), false);
+        std::fill(known.begin(), known.begin() + plan._input_count, true);
+
+        std::queue<unsigned int> sub_equations;
+        for (auto i = 0; i < _equations.size(); i++) {
+            sub_equations.push(i);
+        }
+
+        auto unsolved_since_progress = 0;
+        while (!sub_equations.empty()) {
+            auto index = sub_equations.front();
+            sub_equations.pop();
+
+            auto &[coefficients, total] = _equations[index];
+            std::vector<std::pair<unsigned int, Fraction>> unknown;
+            for (auto &[var, coeff] : coefficients) {
+                if (!known[slots[var]]) {
+                    unknown.emplace_back(slots[var], coeff);
+                }
+            }
+
+            switch (unknown.size()) {
+                case 0:
+                    unsolved_since_progress = 0;
+                    break;
+                case 1: {
+                    auto [target, pivot] = unknown.front();
+                    EvaluationPlan::Step step { target, pivot, total, plan._terms.size(), 0 };
+                    for (auto &[var, coeff] : coefficients) {
+                        if (slots[var] != target) {
+                            plan._terms.push_back({slots[var], coeff});
+                        }
+                    }
+                    step.terms_end = plan._terms.size();
+                    plan._steps.push_back(step);
+
+                    known[target] = true;
+                    unsolved_since_progress = 0;
+                }
+                    break;
+                default: {
+                    if (++unsolved_since_progress > sub_equations.size()) {
+                        throw std::invalid_argument("Not enough inputs to solve the system of linear equations");
+                    }
+                    sub_equations.push(index);
+                }
+                    break;
+            }
+        }
+
+        return plan;
+    }
+
     void SystemOfLinearEquations::print() const {
         std::cout << "Number of Equations: " << _equations.size() << "\n";
         for (auto &[coefficients, total] : _equations) {
@@ -182,4 +445,173 @@ namespace minesweeper::solver::sle {
         }
         std::cout << std::endl;
     }
+
+
+    // IncrementalSystemOfLinearEquations implementation
+    // private methods:
+
+    /**
+     * Mark the component of `key` and all components containing one of the
+     * variables in `coefficients` for re-elimination.
+     * 
+     * @param key key of the changed equation
+     * @param coefficients variables of the changed equation
+     */
+    void IncrementalSystemOfLinearEquations::mark_dirty(Node* key, const Coefficients& coefficients) {
+        if (_row_component.contains(key)) {
+            _dirty_components.insert(_row_component[key]);
+        }
+        for (auto &[var, coeff] : coefficients) {
+            if (_variable_component.contains(var)) {
+                _dirty_components.insert(_variable_component[var]);
+            }
+        }
+    }
+
+    /**
+     * Regroup the equations of all dirty components and pending equations
+     * into components, and convert each of them into row echelon form.
+     */
+    void IncrementalSystemOfLinearEquations::update() {
+        if (_dirty_components.empty() && _pending_keys.empty()) {
+            return;
+        }
+
+        auto keys = _pending_keys;
+        for (auto id : _dirty_components) {
+            auto &component = _components[id];
+            for (auto key : component.keys) {
+                _row_component.erase(key);
+                if (_rows.contains(key)) {
+                    keys.insert(key);
+                }
+            }
+            for (auto var : component.variables) {
+                _variable_component.erase(var);
+            }
+            _components.erase(id);
+        }
+        _dirty_components.clear();
+        _pending_keys.clear();
+
+        // Group the equations by shared variables
+        std::map<Node*, Node*> parent;
+        auto find = [&](Node* key) {
+            while (parent[key] != key) {
+                key = parent[key] = parent[parent[key]];
+            }
+            return key;
+        };
+        std::unordered_map<Node*, Node*> variable_key;
+        for (auto key : keys) {
+            parent[key] = key;
+        }
+        for (auto key : keys) {
+            for (auto &[var, coeff] : _rows[key].first) {
+                auto [it, inserted] = variable_key.insert({var, key});
+                if (!inserted) {
+                    parent[find(key)] = find(it->second);
+                }
+            }
+        }
+        std::map<Node*, std::set<Node*>> groups;
+        for (auto key : keys) {
+            groups[find(key)].insert(key);
+        }
+
+        for (auto &[root, group] : groups) {
+            SystemOfLinearEquations system;
+            for (auto key : group) {
+                system.add_equation(_rows[key].first, _rows[key].second);
+            }
+            system.convert_row_echelon();
+
+            auto id = _next_component++;
+            std::set<Node*> variables;
+            for (auto key : group) {
+                _row_component[key] = id;
+                for (auto &[var, coeff] : _rows[key].first) {
+                    _variable_component[var] = id;
+                    variables.insert(var);
+                }
+            }
+            _components[id] = Component { group, variables, system.equations() };
+        }
+    }
+
+    // public methods:
+    void IncrementalSystemOfLinearEquations::set_equation(Node* key, const Coefficients& coefficients, const Fraction& total) {
+        auto it = _rows.find(key);
+        if (it != _rows.end()) {
+            if (it->second.first == coefficients && it->second.second == total) {
+                return;
+            }
+            mark_dirty(key, it->second.first);
+        }
+        mark_dirty(key, coefficients);
+
+        _rows[key] = {coefficients, total};
+        _pending_keys.insert(key);
+    }
+
+    void IncrementalSystemOfLinearEquations::remove_equation(Node* key) {
+        auto it = _rows.find(key);
+        if (it == _rows.end()) {
+            return;
+        }
+        mark_dirty(key, it->second.first);
+
+        _rows.erase(it);
+        _pending_keys.erase(key);
+    }
+
+    std::set<Node*> IncrementalSystemOfLinearEquations::keys() const {
+        std::set<Node*> keys;
+        for (auto &[key, equation] : _rows) {
+            keys.insert(key);
+        }
+        return keys;
+    }
+
+    unsigned int IncrementalSystemOfLinearEquations::component_count() {
+        update();
+
+        return _components.size();
+    }
+
+    std::vector<Equation> IncrementalSystemOfLinearEquations::equations() {
+        update();
+
+        std::vector<Equation> eqs;
+        for (auto &[id, component] : _components) {
+            eqs.insert(eqs.end(), component.echelon.begin(), component.echelon.end());
+        }
+        return eqs;
+    }
+
+    std::set<Node*> IncrementalSystemOfLinearEquations::independent_variables() {
+        update();
+
+        // In row echelon form, the 1st variable in each equation is dependent
+        std::set<Node*> vars;
+        for (auto &[var, id] : _variable_component) {
+            vars.insert(var);
+        }
+        for (auto &[id, component] : _components) {
+            for (auto &[coefficients, total] : component.echelon) {
+                if (!coefficients.empty()) {
+                    vars.erase(coefficients.begin()->first);
+                }
+            }
+        }
+        return vars;
+    }
+
+    SystemOfLinearEquations IncrementalSystemOfLinearEquations::system() {
+        SystemOfLinearEquations system;
+        for (auto &[coefficients, total] : equations()) {
+            system.add_equation(coefficients, total);
+        }
+        return system;
+    }
 }
\ No newline at end of file
@@ -1,19 +1,22 @@
 #include <set_utils.hpp>
 #include <solver/solver.hpp>
+#include <solver/trace.hpp>
+#include <solver/ring_buffer.hpp>
 #include <stdexcept>
 #include <chrono>
 #include <thread>
-#include "stdlib.h"
 #include <iterator>
 #include <unordered_map>
 #include <map>
 #include <iostream>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 namespace minesweeper::solver {
     using minesweeper::Minesweeper;
 
-    using Fraction = boost::rational<int>;
-
     SolverState::SolverState(const Minefield& minefield) {
         if (minefield.size() == 0 || minefield[0].size() == 0) {
             throw std::invalid_argument("Solver state cannot have zero width or height.");
@@ -52,11 +55,17 @@ namespace minesweeper::solver {
                 }
             }
         }
+        tracked = std::make_shared<Tracked>();
         for (auto x = 0; x < width; x++) {
             for (auto y = 0; y < height; y++) {
                 state[x][y]->set_value(minefield[x][y]);
             }
         }
+        for (auto x = 0; x < width; x++) {
+            for (auto y = 0; y < height; y++) {
+                track(state[x][y]);
+            }
+        }
     }
 
     unsigned int SolverState::width() const {
@@ -67,47 +76,66 @@ namespace minesweeper::solver {
         return state[0].size();
     }
 
-    std::set<Node*> SolverState::covered() {
-        std::set<Node*> covered;
-        for (auto x = 0; x < state.size(); x++) {
-            for (auto y = 0; y < state[x].size(); y++) {
-                if (state[x][y]->value() == Tile::Covered) {
-                    covered.insert(state[x][y]);
-                }
-            }
-        }
-        return covered;
+    const std::set<Node*>& SolverState::covered() const {
+        return tracked->covered;
     }
 
-    std::set<Node*> SolverState::hint_edge() {
+    const std::set<Node*>& SolverState::hint_edge() const {
+        return tracked->hint_edge;
+    }
+
+    std::set<Node*> SolverState::covered_edge() const {
         std::set<Node*> edge_set;
-        for (auto x = 0; x < state.size(); x++) {
-            for (auto y = 0; y < state[x].size(); y++) {
-                if (state[x][y]->hint_edge()) {
-                    edge_set.insert(state[x][y]);
+        for (auto hint : tracked->hint_edge) {
+            for (auto node : hint->adjacent()) {
+                if (node->value() == Tile::Covered) {
+                    edge_set.insert(node);
                 }
             }
         }
         return edge_set;
     }
 
-    std::set<Node*> SolverState::covered_edge() {
-        std::set<Node*> edge_set;
-        for (auto x = 0; x < state.size(); x++) {
-            for (auto y = 0; y < state[x].size(); y++) {
-                if (state[x][y]->covered_edge()) {
-                    edge_set.insert(state[x][y]);
-                }
-            }
+    std::shared_ptr<const std::vector<Node*>> SolverState::changes() const {
+        return { tracked, &tracked->changes };
+    }
+
+    /**
+     * Bring whether `node` is covered or on the hint edge up to date with
+     * its value.
+     * 
+     * @param node node whose value or neighbours' values changed
+     */
+    void SolverState::track(Node* node) {
+        if (node->value() == Tile::Covered) {
+            tracked->covered.insert(node);
+        } else {
+            tracked->covered.erase(node);
+        }
+        if (node->hint_edge()) {
+            tracked->hint_edge.insert(node);
+        } else {
+            tracked->hint_edge.erase(node);
         }
-        return edge_set;
     }
 
     void SolverState::update(Node* node, const minesweeper::Minefield& minefield) {
+        trace::Scope scope("update", "state");
         auto [x, y] = node->coord();
         auto value = minefield[x][y];
 
-        node->set_value(value);
+        if (node->value() != value) {
+            node->set_value(value);
+            tracked->changes.push_back(node);
+            track(node);
+
+            // Only neighbouring hints can join or leave the hint edge
+            for (auto adjacent : node->adjacent()) {
+                if (adjacent->is_hint()) {
+                    track(adjacent);
+                }
+            }
+        }
         if (value == 0) {
             for (auto adjacent_tile : node->adjacent()) {
                 if (adjacent_tile->value() == Tile::Covered) {
@@ -130,57 +158,250 @@ namespace minesweeper::solver {
     }
 
     // State logger
-    StateLogger::StateLogger(unsigned int animation_delay_ms) 
-        : animation_delay { animation_delay_ms} {}
+    StateLogger::StateLogger(unsigned int animation_delay_ms, std::ostream& out)
+        : animation_delay { animation_delay_ms },
+          renderer { out } {}
 
     void StateLogger::set_mode(const char* mode) {
         _mode = mode;
     }
 
-    void StateLogger::log(SolverState state) {
-        system("clear");
-        std::cout << "Solve Mode in Use: " << _mode << "\n\n";
-        auto selected_coords = state.selected().coord();
-        for (auto y = 0; y < state.height(); y++) {
-            for (auto x = 0; x < state.width(); x++) {
-                if (x == selected_coords.first && y == selected_coords.second) {
-                    std::cout << "\x1b[32m"; // Green
+    void StateLogger::log(SolverState& state) {
+        if (frame.width() != state.width() || frame.height() != state.height()) {
+            frame = Frame(state.width(), state.height());
+        }
+        frame.set_mode(_mode);
+        for (auto y = 0U; y < state.height(); y++) {
+            for (auto x = 0U; x < state.width(); x++) {
+                frame.set(x, y, state.get_node(x, y)->value());
+            }
+        }
+        auto [x, y] = state.selected().coord();
+        frame.set_selected(x, y);
+
+        renderer.render(frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(animation_delay));
+    }
+
+    void StateLogger::flush() {
+        renderer.flush();
+    }
+
+
+    // Asynchronous state logger
+    /**
+     * State shared by the solver thread, which produces events, and the
+     * drawing thread, which consumes them.
+     */
+    struct AsyncStateLogger::Shared {
+        // A change to what is shown, small enough to copy through the queue
+        struct Event {
+            enum class Kind : unsigned char {
+                // the board was resized to (x,y)
+                Resize,
+                // the tile at (x,y) now has `value`
+                Tile,
+                // the mode is now `mode`
+                Mode,
+                // a move selecting the tile at (x,y) ended
+                Move,
+                // draw anything held back and report it
+                Flush
+            };
+
+            Kind kind;
+            unsigned char value;
+            unsigned short x, y;
+            const char* mode;
+        };
+
+        // Moves aren't drawn while the queue is fuller than this
+        static constexpr std::size_t backlog = 1024;
+
+        RingBuffer<Event, 4096> events;
+
+        // Bumped whenever events are pushed or stopping is set, for the
+        // drawing thread to wait on
+        std::atomic<unsigned long> pushes = 0;
+        std::atomic<bool> stopping = false;
+        std::atomic<unsigned long> flushes = 0;
+
+        // Only used by the solver thread: what the drawing thread was sent
+        unsigned int width = 0, height = 0;
+        std::vector<Tile> sent;
+
+        // Log of changed nodes of the state logged, how much of it was
+        // sent, and whether the whole board must be compared with `sent`
+        // instead, after a new state or a full queue
+        std::weak_ptr<const std::vector<Node*>> changes;
+        std::size_t logged = 0;
+        bool resend = true;
+        const char* mode = "";
+        const char* sent_mode = nullptr;
+        unsigned long flushes_requested = 0;
+
+        // Only used by the drawing thread
+        unsigned int animation_delay;
+        Frame frame;
+        FrameRenderer renderer;
+
+        std::thread thread;
+
+        Shared(unsigned int animation_delay_ms, std::ostream& out)
+            : animation_delay { animation_delay_ms },
+              renderer { out },
+              thread { [this] { draw(); } } {}
+
+        ~Shared() {
+            stopping = true;
+            pushes++;
+            pushes.notify_one();
+            thread.join();
+        }
+
+        /**
+         * Queue an event, waiting for space in the queue. Only for events
+         * which can't be dropped, and are rare enough that the wait
+         * doesn't matter.
+         */
+        void push(const Event& event) {
+            while (!events.try_push(event)) {
+                std::this_thread::yield();
+            }
+        }
+
+        void notify() {
+            pushes++;
+            pushes.notify_one();
+        }
+
+        /**
+         * Apply events to the frame until stopped, drawing after each move
+         * unless the queue is backed up.
+         */
+        void draw() {
+            while (true) {
+                auto seen = pushes.load();
+                while (auto event = events.try_pop()) {
+                    apply(*event);
                 }
+                if (stopping) {
+                    return;
+                }
+                pushes.wait(seen);
+            }
+        }
 
-                auto value = state.get_node(x, y)->value();
-                switch (value) {
-                    case Tile::Mine:
-                        std::cout << "*";
-                        break;
-                    case Tile::Flag:
-                        std::cout << "f";
-                        break;
-                    case Tile::Covered:
-                        std::cout << "O";
-                        break;
-                    case 0:
-                        std::cout << " ";
-                        break;
-                    default:
-                        std::cout << value;
+        void apply(const Event& event) {
+            switch (event.kind) {
+                case Event::Kind::Resize:
+                    frame = Frame(event.x, event.y);
+                    break;
+                case Event::Kind::Tile:
+                    frame.set(event.x, event.y, static_cast<Tile>(event.value));
+                    break;
+                case Event::Kind::Mode:
+                    frame.set_mode(event.mode);
+                    break;
+                case Event::Kind::Move:
+                    frame.set_selected(event.x, event.y);
+                    if (events.size() < backlog) {
+                        renderer.render(frame);
+                        std::this_thread::sleep_for(std::chrono::milliseconds(animation_delay));
+                    }
+                    break;
+                case Event::Kind::Flush:
+                    renderer.flush();
+                    flushes++;
+                    flushes.notify_all();
+                    break;
+            }
+        }
+    };
+
+    AsyncStateLogger::AsyncStateLogger(unsigned int animation_delay_ms, std::ostream& out)
+        : shared { std::make_shared<Shared>(animation_delay_ms, out) } {}
+
+    void AsyncStateLogger::set_mode(const char* mode) {
+        shared->mode = mode;
+    }
+
+    void AsyncStateLogger::log(SolverState& state) {
+        using Event = Shared::Event;
+        auto &s = *shared;
+        if (s.width != state.width() || s.height != state.height()) {
+            s.push({ Event::Kind::Resize, 0, static_cast<unsigned short>(state.width()), static_cast<unsigned short>(state.height()), nullptr });
+            s.width = state.width();
+            s.height = state.height();
+            s.sent.assign(s.width * s.height, Tile::Covered);
+            s.resend = true;
+        }
+        auto changes = state.changes();
+        if (s.changes.owner_before(changes) || changes.owner_before(s.changes)) {
+            s.changes = changes;
+            s.resend = true;
+        }
+
+        // A change which doesn't fit in the queue isn't marked as sent, so
+        // it is sent with a later move instead
+        auto full = false;
+        if (s.mode != s.sent_mode) {
+            full = !s.events.try_push({ Event::Kind::Mode, 0, 0, 0, s.mode });
+            if (!full) {
+                s.sent_mode = s.mode;
+            }
+        }
+        auto send = [&](unsigned int x, unsigned int y) {
+            auto value = state.get_node(x, y)->value();
+            auto &sent = s.sent[y * s.width + x];
+            if (value != sent) {
+                full = !s.events.try_push({ Event::Kind::Tile, static_cast<unsigned char>(value), static_cast<unsigned short>(x), static_cast<unsigned short>(y), nullptr });
+                if (!full) {
+                    sent = value;
                 }
-                std::cout << " ";
+            }
+        };
 
-                if (x == selected_coords.first && y == selected_coords.second) {
-                    std::cout << "\x1b[0m"; // Reset color
+        // Only the tiles the move changed are sent, unless changes were
+        // dropped, which only comparing the whole board finds again
+        if (s.resend) {
+            for (auto y = 0U; y < s.height && !full; y++) {
+                for (auto x = 0U; x < s.width && !full; x++) {
+                    send(x, y);
                 }
             }
-            std::cout << "\n";
+        } else {
+            for (auto i = s.logged; i < changes->size() && !full; i++) {
+                auto [x, y] = (*changes)[i]->coord();
+                send(x, y);
+            }
+        }
+        s.logged = changes->size();
+        s.resend = full;
+
+        if (!full) {
+            auto [x, y] = state.selected().coord();
+            s.events.try_push({ Event::Kind::Move, 0, static_cast<unsigned short>(x), static_cast<unsigned short>(y), nullptr });
+        }
+        s.notify();
+    }
+
+    void AsyncStateLogger::flush() {
+        auto &s = *shared;
+        s.push({ Shared::Event::Kind::Flush, 0, 0, 0, nullptr });
+        s.notify();
+
+        auto requested = ++s.flushes_requested;
+        for (auto done = s.flushes.load(); done < requested; done = s.flushes.load()) {
+            s.flushes.wait(done);
         }
-        std::cout << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(animation_delay));
     }
     
     // BasicSolver
     std::set<Node*> BasicSolver::flaggable(SolverState state) {
         std::set<Node*> flaggable_nodes;
 
-        auto hint_edge = state.hint_edge();
+        auto &hint_edge = state.hint_edge();
         for (auto hint : hint_edge) {
             if (hint->adjacent_covered_count() == hint->adjacent_mines_left()) {
                 for (auto adj_node: hint->adjacent()) {
@@ -207,10 +428,48 @@ namespace minesweeper::solver {
 
     
     // AdvancedSolver
+    void AdvancedSolver::set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns) {
+        this->patterns = patterns;
+    }
+
+    /**
+     * Find the cells of the hint edge's components which have the same value
+     * in every solution of their pattern in the pattern database.
+     * 
+     * @param state current state of the solver
+     * @param mine true to find the cells which are always mines, false to
+     *      find the cells which are always safe
+     * 
+     * @return cells which are always mines or always safe
+     */
+    std::set<Node*> AdvancedSolver::determined(SolverState& state, bool mine) {
+        std::set<Node*> nodes;
+        if (!patterns) {
+            return nodes;
+        }
+
+        for (auto &component : frontier::components(state.hint_edge())) {
+            if (component.cells.size() > frontier::ComponentCache::max_cells) {
+                continue;
+            }
+            auto counts = patterns->find(component);
+            if (!counts || counts->total() == 0) {
+                continue;
+            }
+            for (auto i = 0U; i < component.cells.size(); i++) {
+                auto mines = counts->cell_total(i);
+                if (mine ? mines == counts->total() : mines == 0) {
+                    nodes.insert(component.cells[i]);
+                }
+            }
+        }
+        return nodes;
+    }
+
     std::set<Node*> AdvancedSolver::flaggable(SolverState state) {
-        std::set<Node*> flag;
+        std::set<Node*> flag = determined(state, true);
 
-        auto hint_edge = state.hint_edge();
+        auto &hint_edge = state.hint_edge();
         for (auto hint : hint_edge) {
             auto node_mines = hint->adjacent_mines_left();
             auto adjacent_covered = hint->adjacent_covered();
@@ -234,9 +493,9 @@ namespace minesweeper::solver {
     }
 
     std::set<Node*> AdvancedSolver::safe(SolverState state) {
-        std::set<Node*> safe_nodes;
+        std::set<Node*> safe_nodes = determined(state, false);
         
-        auto hint_edge = state.hint_edge();
+        auto &hint_edge = state.hint_edge();
         for (auto node : hint_edge) {
             if (node->adjacent_mines_left() == 1) {
                 auto adjacent_covered = node->adjacent_covered();
@@ -261,129 +520,493 @@ namespace minesweeper::solver {
 
 
     // ProbableSolver
-    void ProbableSolver::calculate_probability(SolverState state, int mines_left) {
+    template <typename Numeric>
+    BasicProbableSolver<Numeric>::BasicProbableSolver(Engine engine, unsigned int threads)
+        : engine { engine },
+          pool { threads == 1 ? nullptr : std::make_shared<ThreadPool>(threads) },
+          enumerator { pool } {
+        constexpr std::size_t cache_capacity = 1 << 12;
+        enumerator.set_cache(std::make_shared<frontier::ComponentCache>(cache_capacity));
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_cache(std::shared_ptr<frontier::ComponentCache> cache) {
+        enumerator.set_cache(cache);
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns) {
+        enumerator.set_patterns(patterns);
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_incremental(bool incremental) {
+        this->incremental = incremental;
+        tracker.clear();
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_lookahead(unsigned int rollouts, unsigned int candidates, unsigned long seed) {
+        if (rollouts == 0) {
+            lookahead.reset();
+        } else {
+            lookahead = frontier::LookaheadPolicy(rollouts, candidates, seed, pool);
+        }
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_endgame(bool enabled) {
+        if (enabled) {
+            endgame.emplace();
+        } else {
+            endgame.reset();
+        }
+    }
+
+    template <typename Numeric>
+    const std::vector<frontier::Score>& BasicProbableSolver<Numeric>::guess_scores() const {
+        return scores;
+    }
+
+    template <typename Numeric>
+    const frontier::ComponentTracker& BasicProbableSolver<Numeric>::component_tracker() const {
+        return tracker;
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_sampler(const frontier::MarkovChainSampler& sampler) {
+        this->sampler = sampler;
+    }
+
+    template <typename Numeric>
+    const frontier::Diagnostics& BasicProbableSolver<Numeric>::sampling_diagnostics() const {
+        return sampler.diagnostics();
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_time_budget(std::chrono::nanoseconds budget, unsigned long seed) {
+        time_budget = budget;
+        estimator_seed = seed;
+    }
+
+    template <typename Numeric>
+    const std::map<Node*, typename BasicProbableSolver<Numeric>::Interval>& BasicProbableSolver<Numeric>::confidence() const {
+        return intervals;
+    }
+
+    template <typename Numeric>
+    bool BasicProbableSolver<Numeric>::exact() const {
+        return counted_exactly;
+    }
+
+    template <typename Numeric>
+    typename Numeric::value_type BasicProbableSolver<Numeric>::probability(Node* node) const {
+        return probabilities.at(node);
+    }
+
+    template <typename Numeric>
+    CountingStats BasicProbableSolver<Numeric>::counting_stats() const {
+        auto stats = counting;
+        stats.nodes_visited = enumerator.nodes_visited();
+        return stats;
+    }
+
+    /**
+     * Set the mine probability of a node, keeping its double on the node
+     * for guessing and drawing.
+     * 
+     * @param node covered node
+     * @param probability probability that `node` is a mine
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::set_probability(Node* node, const Number& probability) {
+        probabilities.insert_or_assign(node, probability);
+        node->set_mine_probability(std::clamp(Numeric::to_double(probability), 0.0, 1.0));
+    }
+
+    /**
+     * Set mine probabilities of the covered nodes by brute forcing the
+     * independent variables of the hint edge's system of linear equations.
+     * 
+     * @param hint_edge hint nodes adjacent to a covered node
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::bruteforce_probability(const std::set<Node*>& hint_edge, const std::set<Node*>& non_edge_covered, int mines_left) {
         // Create a system of linear equations like
         // 2 = 1a + 1b + 1c + 1d 
-        // using adjacent mines and covered neighbors
-        sle::SystemOfLinearEquations equations;
-        auto hint_edge = state.hint_edge();
+        // using adjacent mines and covered neighbors.
+        // Equations of hints which haven't changed since the last call keep
+        // their row echelon form
+        for (auto hint : equations.keys()) {
+            if (!hint_edge.contains(hint)) {
+                equations.remove_equation(hint);
+            }
+        }
         for (auto hint : hint_edge) {
             auto mines = hint->adjacent_mines_left();
-            Fraction total { mines };
+            sle::Fraction total { mines };
             sle::Coefficients coefficients;
 
             auto adj_covered = hint->adjacent_covered();
             for (auto node : adj_covered) {
                 coefficients.insert({ node, 1});
             }
-            equations.add_equation(coefficients, total);
+            equations.set_equation(hint, coefficients, total);
         }
 
-        // TODO how to incorporate sum(all_covered) = mines_left?
-
         // Bruteforce the possible values for the independent variables
         auto ind_vars = equations.independent_variables();
-        auto assignments = bruteforce(equations, ind_vars);
+        auto system = equations.system();
+        if constexpr (instrumented) {
+            counting.systems++;
+            counting.equations += hint_edge.size();
+            counting.independent_variables += ind_vars.size();
+        }
+        auto assignments = bruteforce(system, ind_vars);
+        if (!assignments) {
+            sample_probability(frontier::components(hint_edge), non_edge_covered, mines_left);
+            return;
+        }
 
         // Set probabilities of edge nodes
-        auto covered_edge_nodes = state.covered_edge();
-        Fraction total_probability{};
-        for (auto node : covered_edge_nodes) {
-            if (assignments.contains(node)) {
-                node->set_mine_probability(assignments[node]);
-                total_probability += assignments[node];
-            }
+        probabilities.clear();
+        Number total_probability{};
+        for (auto &[node, probability] : *assignments) {
+            set_probability(node, probability);
+            total_probability += probability;
         }
 
-        // Set probabilities of non-edge nodes
-        auto non_edge_covered = set_utils::set_difference(state.covered(), covered_edge_nodes);
+        // Set probabilities of non-edge nodes. The brute force only gives the
+        // expected value of each variable, so sum(all_covered) = mines_left
+        // can only be approximated
         if (non_edge_covered.size() > 0) {
-            auto p = (mines_left - total_probability) / Fraction{non_edge_covered.size()};
+            Number p {};
+            if (total_probability < Number(mines_left)) {
+                p = (Number(mines_left) - total_probability) / Number(static_cast<int>(non_edge_covered.size()));
+            }
+            if (p > Number(1)) {
+                p = Number(1);
+            }
 
             for (auto node : non_edge_covered) {
-                if (p > 1) { // hack due to not using sum(all_covered) = mines_left
-                    p = 1;
-                }
-                node->set_mine_probability(p);
+                set_probability(node, p);
             }
         }
     }
 
-    bool ProbableSolver::validate_assignments(sle::Assignments assignments) {
-        for (auto &[var, value] : assignments) {
-            if (value < 0 || value > 1) {
-                return false;
+    /**
+     * Set mine probabilities of the covered nodes by counting the solutions
+     * of each component of the hint edge exactly, weighted by the number of
+     * ways the remaining mines can be placed in the interior.
+     * 
+     * @param components components of the hint edge
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::enumerate_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left) {
+
+        std::vector<frontier::Counts> counts;
+        std::vector<std::vector<double>> margins;
+        if (time_budget.count() == 0) {
+            counted_exactly = true;
+            auto exact_counts = count_changed(components, [this](auto &changed) {
+                auto counts = enumerator.count(changed);
+                return std::vector<std::optional<frontier::Counts>>(counts.begin(), counts.end());
+            });
+            for (auto c = 0U; c < components.size(); c++) {
+                counts.push_back(std::move(*exact_counts[c]));
+                margins.emplace_back(components[c].cells.size(), 0.0);
+            }
+        } else {
+            // Count exactly for most of the budget, then estimate whatever
+            // is left in the rest
+            auto start = frontier::Clock::now();
+            auto deadline = start + time_budget;
+            auto exact_counts = count_changed(components, [this, start](auto &changed) {
+                return enumerator.count_until(changed, start + time_budget * 3 / 4);
+            });
+
+            auto unfinished = std::count(exact_counts.begin(), exact_counts.end(), std::nullopt);
+            counted_exactly = unfinished == 0;
+            frontier::ProbeEstimator estimator { estimator_seed };
+            constexpr unsigned long min_probes = 64;
+            constexpr unsigned long max_probes = 1UL << 20;
+            for (auto c = 0U; c < components.size(); c++) {
+                if (exact_counts[c]) {
+                    counts.push_back(std::move(*exact_counts[c]));
+                    margins.emplace_back(components[c].cells.size(), 0.0);
+                    continue;
+                }
+
+                // Share the remaining time between the unfinished components
+                auto share = (deadline - frontier::Clock::now()) / unfinished--;
+                auto estimate = estimator.estimate(components[c], frontier::Clock::now() + share, min_probes, max_probes);
+                counts.push_back(std::move(estimate.counts));
+                margins.push_back(std::move(estimate.margins));
             }
         }
-        return true;
+
+        apply_counts(components, counts, margins, non_edge_covered, mines_left);
     }
 
-    sle::Assignments ProbableSolver::bruteforce(sle::SystemOfLinearEquations& sys_eq, const std::set<Node*>& ind_vars) {
-        std::unordered_map<Node*, unsigned int> var_bit_map;
-        
-        std::unordered_map<Node*, Fraction> values_valid;
-
-        auto i = 0;
-        for (auto var : ind_vars) {
-            var_bit_map.insert({var, i});
-            values_valid.insert({var, 0});
-            i++;
-        }
-        auto sample = ind_vars.size() > 10;
-        auto max = 1UL << ind_vars.size();
-
-        std::mt19937_64 rng(std::random_device{}());
-        std::uniform_int_distribution<unsigned long> sample_dist(0, max);
-
-        auto total_valid = 0;
-        auto range_max = sample ? 1UL << 10 : max;
-        for (auto i = 0UL; i < range_max; i++) {
-            sle::Assignments assignments;
-            auto value = sample ? sample_dist(rng) : i;
-            for (auto var : ind_vars) {
-                assignments.insert({
-                    var,
-                    (i >> var_bit_map[var]) & 1
-                });
-            }
-            sys_eq.evaluate(assignments);
-            if (validate_assignments(assignments)) {
-                for (auto &[var, value] : assignments) {
-                    values_valid[var] += value;
+    /**
+     * Set mine probabilities of the covered nodes by counting the solutions
+     * of each component of the hint edge with a profile sweep, or with the
+     * backtracking search for components too wide to sweep.
+     * 
+     * @param components components of the hint edge
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::profile_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left) {
+
+        auto exact_counts = count_changed(components, [this](auto &changed) {
+            frontier::ProfileCounter profile;
+            std::vector<std::optional<frontier::Counts>> counts;
+            for (auto &component : changed) {
+                if (frontier::ProfileCounter::width(component) <= frontier::ProfileCounter::max_width) {
+                    counts.push_back(profile.count(component));
+                } else {
+                    counts.push_back(enumerator.count(component));
                 }
-                total_valid++;
             }
+            return counts;
+        });
+
+        std::vector<frontier::Counts> counts;
+        std::vector<std::vector<double>> margins;
+        for (auto c = 0U; c < components.size(); c++) {
+            counts.push_back(std::move(*exact_counts[c]));
+            margins.emplace_back(components[c].cells.size(), 0.0);
+        }
+
+        counted_exactly = true;
+        apply_counts(components, counts, margins, non_edge_covered, mines_left);
+    }
+
+    /**
+     * Set mine probabilities of the covered nodes by counting the models of
+     * each component of the hint edge.
+     * 
+     * @param components components of the hint edge
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::model_count_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left) {
+
+        auto exact_counts = count_changed(components, [this](auto &changed) {
+            std::vector<std::optional<frontier::Counts>> counts;
+            for (auto &component : changed) {
+                counts.push_back(counter.count(component));
+            }
+            return counts;
+        });
+
+        std::vector<frontier::Counts> counts;
+        std::vector<std::vector<double>> margins;
+        for (auto c = 0U; c < components.size(); c++) {
+            counts.push_back(std::move(*exact_counts[c]));
+            margins.emplace_back(components[c].cells.size(), 0.0);
+        }
+
+        counted_exactly = true;
+        apply_counts(components, counts, margins, non_edge_covered, mines_left);
+    }
+
+    /**
+     * Count the components of the hint edge which changed since the last
+     * call, reusing the exact counts of the rest.
+     * 
+     * @param components components of the hint edge
+     * @param count counts the given changed components, giving no value for
+     *      those it couldn't count exactly
+     * 
+     * @return counts of each component, or no value for those `count`
+     *      couldn't count exactly
+     */
+    template <typename Numeric>
+    std::vector<std::optional<frontier::Counts>> BasicProbableSolver<Numeric>::count_changed(const std::vector<frontier::Component>& components, const std::function<std::vector<std::optional<frontier::Counts>>(const std::vector<frontier::Component>&)>& count) {
+        if (!incremental) {
+            return count(components);
+        }
+
+        auto counts = tracker.find(components);
+        std::vector<frontier::Component> changed;
+        for (auto c = 0U; c < components.size(); c++) {
+            if (!counts[c]) {
+                changed.push_back(components[c]);
+            }
+        }
+
+        auto changed_counts = count(changed);
+        for (auto c = 0U, i = 0U; c < components.size(); c++) {
+            if (!counts[c]) {
+                counts[c] = std::move(changed_counts[i++]);
+            }
+        }
+        tracker.update(components, counts);
+        return counts;
+    }
+
+    /**
+     * Set mine probabilities of the covered nodes from the solution counts
+     * of each component of the hint edge.
+     * 
+     * @param components components of the hint edge
+     * @param counts solution counts of each component
+     * @param margins half width of the confidence interval of each cell's
+     *      probability, 0 for exactly counted cells
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::apply_counts(const std::vector<frontier::Component>& components, const std::vector<frontier::Counts>& counts, const std::vector<std::vector<double>>& margins, const std::set<Node*>& non_edge_covered, int mines_left) {
+        intervals.clear();
+        probabilities.clear();
+        auto combined = frontier::combine<Numeric>(counts, non_edge_covered.size(), mines_left);
+        for (auto c = 0U; c < components.size(); c++) {
+            auto &cells = components[c].cells;
+            for (auto i = 0U; i < cells.size(); i++) {
+                set_probability(cells[i], combined.cells[c][i]);
+                auto p = Numeric::to_double(combined.cells[c][i]);
+                intervals[cells[i]] = { std::max(p - margins[c][i], 0.0), std::min(p + margins[c][i], 1.0) };
+            }
+        }
+
+        for (auto node : non_edge_covered) {
+            set_probability(node, combined.interior);
+        }
+    }
+
+    /**
+     * Set mine probabilities of the covered nodes by sampling the mine
+     * configurations of the hint edge with a Markov chain.
+     * 
+     * @param components components of the hint edge
+     * @param non_edge_covered covered nodes not adjacent to a hint node
+     * @param mines_left number of mines not yet flagged
+     */
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::sample_probability(const std::vector<frontier::Component>& components, const std::set<Node*>& non_edge_covered, int mines_left) {
+        auto sampled = sampler.sample(components, non_edge_covered.size(), mines_left);
+        counted_exactly = false;
+        intervals.clear();
+        probabilities.clear();
+        for (auto c = 0U; c < components.size(); c++) {
+            auto &cells = components[c].cells;
+            for (auto i = 0U; i < cells.size(); i++) {
+                set_probability(cells[i], Numeric::from_double(sampled.cells[c][i]));
+            }
+        }
+
+        auto interior = Numeric::from_double(sampled.interior);
+        for (auto node : non_edge_covered) {
+            set_probability(node, interior);
+        }
+    }
+
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::calculate_probability(SolverState& state, int mines_left) {
+        trace::Scope scope("calculate_probability", "probability");
+        auto &hint_edge = state.hint_edge();
+        auto non_edge_covered = set_utils::set_difference(state.covered(), state.covered_edge());
+
+        if (engine == Engine::Bruteforce) {
+            bruteforce_probability(hint_edge, non_edge_covered, mines_left);
+            return;
+        }
+
+        // Only the components around the nodes changed since the last call
+        // are rebuilt, unless counting from scratch
+        auto components = incremental ? tracker.components(hint_edge, state.changes()) : frontier::components(hint_edge);
+        if (engine == Engine::Sampling) {
+            sample_probability(components, non_edge_covered, mines_left);
+        } else if (engine == Engine::Profile) {
+            profile_probability(components, non_edge_covered, mines_left);
+        } else if (engine == Engine::ModelCounting) {
+            model_count_probability(components, non_edge_covered, mines_left);
+        } else {
+            enumerate_probability(components, non_edge_covered, mines_left);
+        }
+    }
+
+    template <typename Numeric>
+    std::optional<std::unordered_map<Node*, typename Numeric::value_type>> BasicProbableSolver<Numeric>::bruteforce(sle::SystemOfLinearEquations& sys_eq, const std::set<Node*>& ind_vars) {
+        auto plan = sys_eq.compile(ind_vars);
+        sle::BatchEvaluator evaluator(plan);
+        auto &variables = plan.variables();
+
+        // Enumerate every combination up to 2^24, otherwise leave it to
+        // the sampler
+        auto max_exhaustive_batch_inputs = 18U;
+        if (evaluator.batch_inputs() > max_exhaustive_batch_inputs) {
+            return std::nullopt;
+        }
+
+        std::vector<std::uint64_t> mine_counts(variables.size());
+        std::vector<std::uint8_t> batch_values(evaluator.batch_inputs());
+        std::uint64_t total_valid = 0;
+
+        auto max = 1UL << evaluator.batch_inputs();
+        for (auto batch = 0UL; batch < max; batch++) {
+            for (auto i = 0U; i < batch_values.size(); i++) {
+                batch_values[i] = (batch >> i) & 1;
+            }
+            total_valid += evaluator.evaluate(batch_values, mine_counts);
         }
         total_valid = total_valid > 0 ? total_valid : 1;
 
-        sle::Assignments assignments;
-        for (auto &[var, value] : values_valid) {
+        std::unordered_map<Node*, Number> assignments;
+        auto total = Numeric::count(static_cast<double>(total_valid));
+        for (auto slot = 0U; slot < variables.size(); slot++) {
             assignments.insert({
-                var,
-                value / total_valid
+                variables[slot],
+                Numeric::count(static_cast<double>(mine_counts[slot])) / total
             });
         }
-        sys_eq.evaluate(assignments);
-
         return assignments;
     }
 
-    Node* ProbableSolver::solve(SolverState state, int mines_left) {
+    template <typename Numeric>
+    Node* BasicProbableSolver<Numeric>::solve(SolverState& state, int mines_left) {
         calculate_probability(state, mines_left);
 
         // print_probabilities(state);
 
         auto covered_nodes = state.covered();
+        scores.clear();
+        if (endgame && covered_nodes.size() <= frontier::EndgameSolver::max_cells) {
+            if (auto move = endgame->solve(covered_nodes, mines_left)) {
+                return move->node;
+            }
+        }
+        if (lookahead) {
+            scores = lookahead->score(frontier::components(state.hint_edge()), covered_nodes, mines_left);
+            if (!scores.empty()) {
+                return scores.front().node;
+            }
+        }
+
+        // Ties go to the first node in coordinate order, so the guess doesn't
+        // depend on where the nodes were allocated
         Node* least_probable = *covered_nodes.begin();
         for (auto node : covered_nodes) {
-            if (node->mine_probability() < least_probable->mine_probability()) {
+            auto &probability = probabilities.at(node);
+            auto &least = probabilities.at(least_probable);
+            if (probability < least || (probability == least && node->coord() < least_probable->coord())) {
                 least_probable = node;
             }
         }
         return least_probable;
     }
 
-    void ProbableSolver::print_probabilities(SolverState state) {
+    template <typename Numeric>
+    void BasicProbableSolver<Numeric>::print_probabilities(SolverState& state) {
         std::cout << "\n";
         for (auto y = 0; y < state.height(); y++) {
             for (auto x = 0; x < state.width(); x++) {
@@ -399,20 +1022,56 @@ namespace minesweeper::solver {
         std::cout << std::endl;
     }
 
+    template class BasicProbableSolver<numeric::Float>;
+    template class BasicProbableSolver<numeric::LogSpace>;
+    template class BasicProbableSolver<numeric::Exact>;
+
     
     // Main solver
-    MinesweeperSolver::MinesweeperSolver(Minesweeper game, StateLogger logger)
+    template <typename Logger>
+    BasicMinesweeperSolver<Logger>::BasicMinesweeperSolver(Minesweeper game, Logger logger)
         : game { game },
           state { SolverState(game.get_field()) },
           logger { logger } {}
 
-    void MinesweeperSolver::flag_or_uncover(Node* node, bool flag) {
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::set_patterns(std::shared_ptr<const frontier::PatternDatabase> patterns) {
+        this->patterns = patterns;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::set_cache(std::shared_ptr<frontier::ComponentCache> cache) {
+        this->cache = cache;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::set_lookahead(unsigned int rollouts) {
+        lookahead_rollouts = rollouts;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::set_endgame(bool enabled) {
+        endgame = enabled;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::set_record_moves(bool enabled) {
+        record_moves = enabled;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::flag_or_uncover(Node* node, bool flag) {
+        auto [x, y] = node->coord();
+        trace::Scope scope(flag ? "flag" : "uncover", "move", x, y);
         Minesweeper::GameState game_state;
 
         state.set_selected(node);
         logger.log(state);
+        if (!finished) {
+            result.moves++;
+            result.phase_moves[phase]++;
+        }
 
-        auto [x, y] = node->coord();
         if (flag) {
             game.toggle_flag(x, y);
             game_state = Minesweeper::GameState::Continue;
@@ -422,50 +1081,104 @@ namespace minesweeper::solver {
         state.update(node, game.get_field());
         logger.log(state);
 
+        // A move's time runs from the end of the previous move, so it
+        // includes choosing the move
+        if (record_moves && !finished) {
+            auto now = frontier::Clock::now();
+            result.move_times.push_back(now - last_move);
+            last_move = now;
+        }
+
         check_game_state(game_state);
     }
 
-    void MinesweeperSolver::check_game_state(Minesweeper::GameState game_state) {
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::check_game_state(Minesweeper::GameState game_state) {
         switch (game_state) {
             case Minesweeper::GameState::Lose: {
-                std::cout << "Oops! Clicked on a mine." << std::endl;
-                exit(1);
+                finished = true;
+                result.won = false;
+                return;
             }
             case Minesweeper::GameState::Win: {
-                for (auto node : state.covered()) {
+                // Flag the mines left for show, not as moves
+                finished = true;
+                result.won = true;
+                auto covered = state.covered();
+                for (auto node : covered) {
                     flag_or_uncover(node, true);
                 }
-                std::cout << "Minefield Swept!" << std::endl;
-                exit(0);
+                return;
             }
             default:
                 return;
         }
     }
 
-    void MinesweeperSolver::flag_all(std::set<Node*> nodes) {
+    /**
+     * Move on to the given stage, adding the time since the last stage was
+     * entered to that stage, if instrumented.
+     * 
+     * @param next stage to enter
+     */
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::enter(Phase next) {
+        if constexpr (instrumented) {
+            auto now = frontier::Clock::now();
+            result.stats.phases[phase].time += now - phase_start;
+            trace::complete(phase_name(phase), "phase", phase_start, now);
+            result.stats.phases[next].passes++;
+            phase_start = now;
+        }
+        phase = next;
+    }
+
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::flag_all(std::set<Node*> nodes) {
         for (auto node : nodes) {
+            if (finished) {
+                return;
+            }
             flag_or_uncover(node, true);
         }
     }
 
-    void MinesweeperSolver::uncover_all(std::set<Node*> nodes) {
+    template <typename Logger>
+    void BasicMinesweeperSolver<Logger>::uncover_all(std::set<Node*> nodes) {
         for (auto node : nodes) {
+            if (finished) {
+                return;
+            }
             flag_or_uncover(node, false);
         }
     }
 
-    void MinesweeperSolver::solve() {
+    template <typename Logger>
+    SolveResult BasicMinesweeperSolver<Logger>::solve() {
+        auto start = frontier::Clock::now();
+        auto start_allocations = instrumented ? allocations() : 0ULL;
+
         BasicSolver basic;
         AdvancedSolver advanced;
         ProbableSolver probable;
+        advanced.set_patterns(patterns);
+        probable.set_patterns(patterns);
+        if (cache) {
+            probable.set_cache(cache);
+        }
+        probable.set_lookahead(lookahead_rollouts);
+        probable.set_endgame(endgame);
 
-        Minesweeper::GameState game_state;
         auto x = game.width/2;
         auto y = game.height/2;
+        phase_start = start;
+        last_move = start;
+        enter(Phase::Opening);
+        result.guesses++;
         flag_or_uncover(state.get_node(x, y), false);
 
-        while (true) {
+        while (!finished) {
+            enter(Phase::Basic);
             logger.set_mode("Basic");
             auto mine_nodes = basic.flaggable(state);
             flag_all(mine_nodes);
@@ -474,6 +1187,7 @@ namespace minesweeper::solver {
             if (safe_nodes.size() > 0) {
                 uncover_all(safe_nodes);
             } else {
+                enter(Phase::Advanced);
                 logger.set_mode("Advanced");
                 mine_nodes = advanced.flaggable(state);
                 flag_all(mine_nodes);
@@ -482,11 +1196,33 @@ namespace minesweeper::solver {
                 if (safe_nodes.size() > 0) {
                     uncover_all(safe_nodes);
                 } else {
+                    enter(Phase::Probable);
                     logger.set_mode("Most probable (this might blow up)");
                     auto picked = probable.solve(state, game.mines_left());
+                    if (picked->mine_probability() > 0) {
+                        result.guesses++;
+                    }
                     flag_or_uncover(picked, false);
                 }
             }
         }
+
+        result.elapsed = frontier::Clock::now() - start;
+        logger.flush();
+        if constexpr (instrumented) {
+            auto now = frontier::Clock::now();
+            result.stats.phases[phase].time += now - phase_start;
+            trace::complete(phase_name(phase), "phase", phase_start, now);
+            for (auto &[moved_phase, moves] : result.phase_moves) {
+                result.stats.phases[moved_phase].moves = moves;
+            }
+            result.stats.counting = probable.counting_stats();
+            result.stats.allocations = allocations() - start_allocations;
+        }
+        return result;
     }
-}
\ No newline at end of file
+
+    template class BasicMinesweeperSolver<StateLogger>;
+    template class BasicMinesweeperSolver<NullLogger>;
+    template class BasicMinesweeperSolver<AsyncStateLogger>;
+}
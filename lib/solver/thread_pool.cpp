@@ -0,0 +1,139 @@
+#include <solver/thread_pool.hpp>
+#include <algorithm>
+
+namespace minesweeper::solver {
+    ThreadPool::ThreadPool(unsigned int threads) {
+        if (threads == 0) {
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        for (auto i = 0U; i < threads; i++) {
+            _queues.push_back(std::make_unique<Queue>());
+        }
+        // Queue 0 belongs to the thread calling run()
+        for (auto i = 1U; i < threads; i++) {
+            _threads.emplace_back(&ThreadPool::worker, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (auto &thread : _threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Take a task from the back of this thread's queue, or steal one from the
+     * front of another thread's queue.
+     * 
+     * @param self index of the calling thread's queue
+     * @param task set to the task taken
+     * 
+     * @return a task was taken
+     */
+    bool ThreadPool::take(unsigned int self, Task& task) {
+        {
+            auto &own = *_queues[self];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (auto i = 1U; i < _queues.size(); i++) {
+            auto &victim = *_queues[(self + i) % _queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Run tasks until there are none left to take.
+     * 
+     * @param self index of the calling thread's queue
+     */
+    void ThreadPool::work(unsigned int self) {
+        Task task;
+        while (take(self, task)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard lock(_mutex);
+                if (!_error) {
+                    _error = std::current_exception();
+                }
+            }
+
+            if (--_pending == 0) {
+                std::lock_guard lock(_mutex);
+                _done.notify_all();
+            }
+        }
+    }
+
+    /**
+     * Main loop of a pool thread: wait for a batch of tasks, then work on it.
+     * 
+     * @param self index of the thread's queue
+     */
+    void ThreadPool::worker(unsigned int self) {
+        unsigned long seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(_mutex);
+                _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+                if (_stopping) {
+                    return;
+                }
+                seen = _generation;
+            }
+            work(self);
+        }
+    }
+
+    unsigned int ThreadPool::size() const {
+        return _queues.size();
+    }
+
+    void ThreadPool::run(std::vector<std::function<void()>> tasks) {
+        if (tasks.empty()) {
+            return;
+        }
+
+        std::lock_guard run_lock(_run_mutex);
+        _pending = tasks.size();
+        for (auto i = 0U; i < tasks.size(); i++) {
+            auto &queue = *_queues[i % _queues.size()];
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.push_back(std::move(tasks[i]));
+        }
+        {
+            std::lock_guard lock(_mutex);
+            _generation++;
+        }
+        _wake.notify_all();
+
+        work(0);
+
+        std::unique_lock lock(_mutex);
+        _done.wait(lock, [&] { return _pending == 0; });
+
+        if (_error) {
+            auto error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+}
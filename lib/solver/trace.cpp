@@ -0,0 +1,102 @@
+#include <solver/trace.hpp>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace minesweeper::solver::trace {
+    namespace {
+        struct Event {
+            const char* name;
+            const char* category;
+            Clock::time_point begin, end;
+            int x, y;
+        };
+
+        /**
+         * Events recorded by one thread. Only that thread appends to it, so
+         * recording takes no lock.
+         */
+        struct Buffer {
+            unsigned int thread;
+            std::vector<Event> events;
+        };
+
+        std::atomic<bool> recording = false;
+        Clock::time_point epoch;
+
+        // Buffers of every thread which has recorded an event
+        std::mutex registry_mutex;
+        std::vector<std::shared_ptr<Buffer>> registry;
+
+        /**
+         * Get the calling thread's buffer, registering it on first use.
+         */
+        Buffer& local_buffer() {
+            thread_local std::shared_ptr<Buffer> buffer = [] {
+                std::lock_guard lock(registry_mutex);
+                auto buffer = std::make_shared<Buffer>();
+                buffer->thread = registry.size();
+                registry.push_back(buffer);
+                return buffer;
+            }();
+            return *buffer;
+        }
+
+        double microseconds(Clock::duration duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        }
+    }
+
+    void start() {
+        std::lock_guard lock(registry_mutex);
+        for (auto &buffer : registry) {
+            buffer->events.clear();
+        }
+        epoch = Clock::now();
+        recording = instrumented;
+    }
+
+    void stop() {
+        recording = false;
+    }
+
+    bool active() {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    void complete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end, int x, int y) {
+        if (!active()) {
+            return;
+        }
+        local_buffer().events.push_back({ name, category, begin, end, x, y });
+    }
+
+    void write(std::ostream& out) {
+        std::lock_guard lock(registry_mutex);
+        auto flags = out.flags();
+        auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[";
+        auto first = true;
+        for (auto &buffer : registry) {
+            for (auto &event : buffer->events) {
+                out << (first ? "\n" : ",\n")
+                    << "{\"name\":\"" << event.name
+                    << "\",\"cat\":\"" << event.category
+                    << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->thread
+                    << ",\"ts\":" << microseconds(event.begin - epoch)
+                    << ",\"dur\":" << microseconds(event.end - event.begin);
+                if (event.x >= 0) {
+                    out << ",\"args\":{\"x\":" << event.x << ",\"y\":" << event.y << "}";
+                }
+                out << "}";
+                first = false;
+            }
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
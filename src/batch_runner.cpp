@@ -0,0 +1,108 @@
+#include <solver/solver.hpp>
+#include <solver/thread_pool.hpp>
+#include <solver/trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+
+/**
+ * Get the `p`th percentile of sorted latencies, by nearest rank.
+ */
+static double percentile(const std::vector<std::chrono::nanoseconds>& sorted, double p) {
+    auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    auto index = std::clamp<std::size_t>(rank, 1, sorted.size()) - 1;
+    return std::chrono::duration<double, std::milli>(sorted[index]).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <width> <height> <mines> [seed] [games] [threads] [stats output] [trace output]" << std::endl;
+        return 1;
+    }
+
+    unsigned int width = std::stoul(argv[1]);
+    unsigned int height = std::stoul(argv[2]);
+    unsigned int mines = std::stoul(argv[3]);
+    auto seed = argc > 4 ? std::stoul(argv[4]) : 0UL;
+    auto games = argc > 5 ? std::stoul(argv[5]) : 1000UL;
+    unsigned int threads = argc > 6 ? std::stoul(argv[6]) : 0U;
+    std::string stats_output = argc > 7 ? argv[7] : "";
+    std::string trace_output = argc > 8 ? argv[8] : "";
+
+    // Each thread plays every games'th game from its own offset, with its
+    // own solvers and component cache, and keeps its own results
+    ThreadPool pool(threads);
+    std::vector<std::vector<std::pair<unsigned long, SolveResult>>> thread_results(pool.size());
+    std::vector<std::function<void()>> tasks;
+    for (auto t = 0U; t < pool.size(); t++) {
+        tasks.push_back([&, t]() {
+            constexpr std::size_t cache_capacity = 1 << 14;
+            auto cache = std::make_shared<frontier::ComponentCache>(cache_capacity);
+            for (auto game = t; game < games; game += pool.size()) {
+                Minesweeper minesweeper(MinefieldGenerator(seed + game), width, height, mines);
+                HeadlessSolver solver(minesweeper);
+                solver.set_cache(cache);
+                thread_results[t].push_back({ seed + game, solver.solve() });
+            }
+        });
+    }
+
+    if (!trace_output.empty()) {
+        trace::start();
+    }
+    auto start = std::chrono::steady_clock::now();
+    pool.run(tasks);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!trace_output.empty()) {
+        trace::stop();
+        std::ofstream out(trace_output);
+        trace::write(out);
+    }
+
+    auto wins = 0UL;
+    std::vector<std::chrono::nanoseconds> latencies;
+    for (auto &results : thread_results) {
+        for (auto &[game_seed, result] : results) {
+            wins += result.won;
+            latencies.push_back(result.elapsed);
+        }
+    }
+
+    if (!stats_output.empty()) {
+        // One JSON object per game, with per phase stats if instrumented
+        std::ofstream out(stats_output);
+        for (auto &results : thread_results) {
+            for (auto &[game_seed, result] : results) {
+                out << "{\"seed\":" << game_seed
+                    << ",\"won\":" << (result.won ? "true" : "false")
+                    << ",\"moves\":" << result.moves
+                    << ",\"guesses\":" << result.guesses
+                    << ",\"elapsed_ns\":" << result.elapsed.count()
+                    << ",\"stats\":" << result.stats.json() << "}\n";
+            }
+        }
+    }
+    if (latencies.empty()) {
+        std::cout << "No games played" << std::endl;
+        return 0;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Games: " << latencies.size() << " (" << width << "x" << height << ", " << mines << " mines, seeds "
+        << seed << "-" << seed + games - 1 << ", " << pool.size() << " threads)\n";
+    std::cout << "Win rate: " << 100.0 * wins / latencies.size() << "% (" << wins << " won)\n";
+    std::cout << "Throughput: " << latencies.size() / elapsed.count() << " games/s\n";
+    std::cout << "Latency (ms): p50 " << percentile(latencies, 0.50)
+        << ", p95 " << percentile(latencies, 0.95)
+        << ", p99 " << percentile(latencies, 0.99) << std::endl;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <solver/solver.hpp>
+#include <utility>
+
+namespace minesweeper::benchmarks {
+    /**
+     * Play a game with the given seed using only the Basic and Advanced
+     * solvers, stopping at the first position where a guess is needed.
+     * 
+     * @return game and solver state at the first guess
+     */
+    inline std::pair<Minesweeper, solver::SolverState> first_guess(unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+        Minesweeper game(MinefieldGenerator(seed), width, height, mines);
+        solver::SolverState state(game.get_field());
+        game.uncover_tile(width/2, height/2);
+        state.update(state.get_node(width/2, height/2), game.get_field());
+
+        solver::BasicSolver basic;
+        solver::AdvancedSolver advanced;
+        while (true) {
+            auto flaggable = basic.flaggable(state);
+            flaggable.merge(advanced.flaggable(state));
+            for (auto node : flaggable) {
+                auto [x, y] = node->coord();
+                game.toggle_flag(x, y);
+                state.update(node, game.get_field());
+            }
+
+            auto safe = basic.safe(state);
+            safe.merge(advanced.safe(state));
+            if (safe.empty()) {
+                break;
+            }
+            for (auto node : safe) {
+                auto [x, y] = node->coord();
+                game.uncover_tile(x, y);
+                state.update(node, game.get_field());
+            }
+        }
+        return { game, state };
+    }
+}
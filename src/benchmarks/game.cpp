@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include <minesweeper.hpp>
+
+using namespace minesweeper;
+
+static void BM_Generate(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines) {
+    MinefieldGenerator generator(1);
+    for (auto _ : bm_state) {
+        benchmark::DoNotOptimize(generator.generate(width, height, mines));
+    }
+    bm_state.SetItemsProcessed(bm_state.iterations() * width * height);
+}
+
+/**
+ * Uncover the middle of a sparse board, flood filling most of it. Each
+ * iteration uncovers a fresh copy of the game, copied outside the timing.
+ */
+static void BM_UncoverFloodFill(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines) {
+    Minesweeper fresh(MinefieldGenerator(1), width, height, mines);
+    auto uncovered = 0U;
+    for (auto _ : bm_state) {
+        bm_state.PauseTiming();
+        auto game = fresh;
+        bm_state.ResumeTiming();
+        benchmark::DoNotOptimize(game.uncover_tile(width/2, height/2));
+        uncovered = width * height - game.covered_tiles_count();
+    }
+    bm_state.counters["uncovered"] = uncovered;
+    bm_state.SetItemsProcessed(bm_state.iterations() * uncovered);
+}
+
+BENCHMARK_CAPTURE(BM_Generate, beginner, 9, 9, 10);
+BENCHMARK_CAPTURE(BM_Generate, intermediate, 16, 16, 40);
+BENCHMARK_CAPTURE(BM_Generate, expert, 30, 16, 99);
+BENCHMARK_CAPTURE(BM_Generate, large, 200, 200, 8000);
+
+BENCHMARK_CAPTURE(BM_UncoverFloodFill, sparse_30x16, 30, 16, 10);
+BENCHMARK_CAPTURE(BM_UncoverFloodFill, sparse_200x200, 200, 200, 100);
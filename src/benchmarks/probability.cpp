@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <solver/solver.hpp>
+#include "boards.hpp"
+#include "../tests/solver/components.hpp"
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+using minesweeper::benchmarks::first_guess;
+using minesweeper::tests::wall;
+
+static void BM_CalculateProbability(benchmark::State& bm_state, ProbableSolver::Engine engine, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed, unsigned int threads = 1) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    bm_state.counters["covered_edge"] = state.covered_edge().size();
+
+    ProbableSolver fresh(engine, threads);
+    fresh.set_cache(nullptr);
+    for (auto _ : bm_state) {
+        // Copies share the thread pool but not the equations kept between calls
+        auto probable = fresh;
+        probable.calculate_probability(state, game.mines_left());
+    }
+}
+
+static void BM_CalculateProbabilityUnchanged(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    bm_state.counters["covered_edge"] = state.covered_edge().size();
+
+    // Every component is clean after the first call, so only the
+    // combination of the components' counts is redone
+    ProbableSolver probable;
+    probable.set_cache(nullptr);
+    probable.calculate_probability(state, game.mines_left());
+    for (auto _ : bm_state) {
+        probable.calculate_probability(state, game.mines_left());
+    }
+}
+
+static void BM_CalculateProbabilityCached(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    bm_state.counters["covered_edge"] = state.covered_edge().size();
+
+    auto cache = std::make_shared<frontier::ComponentCache>(1024);
+    ProbableSolver fresh;
+    fresh.set_cache(cache);
+    for (auto _ : bm_state) {
+        auto probable = fresh;
+        probable.calculate_probability(state, game.mines_left());
+    }
+    bm_state.counters["hit_rate"] = cache->hit_rate();
+}
+
+/**
+ * Count the solutions of a wall of hints, with rows as long as the
+ * benchmark's range.
+ */
+template <typename Counter>
+static void BM_CountWall(benchmark::State& bm_state) {
+    auto length = static_cast<unsigned int>(bm_state.range(0));
+    auto long_wall = wall(length);
+
+    Counter counter;
+    for (auto _ : bm_state) {
+        benchmark::DoNotOptimize(counter.count(long_wall));
+    }
+    bm_state.SetComplexityN(length);
+}
+
+// Seeds are picked so that the first guess has a non-trivial hint edge
+BENCHMARK_CAPTURE(BM_CalculateProbability, bruteforce_beginner, ProbableSolver::Engine::Bruteforce, 9, 9, 10, 5);
+BENCHMARK_CAPTURE(BM_CalculateProbability, backtracking_beginner, ProbableSolver::Engine::Backtracking, 9, 9, 10, 5);
+BENCHMARK_CAPTURE(BM_CalculateProbability, bruteforce_intermediate, ProbableSolver::Engine::Bruteforce, 16, 16, 40, 39);
+BENCHMARK_CAPTURE(BM_CalculateProbability, backtracking_intermediate, ProbableSolver::Engine::Backtracking, 16, 16, 40, 39);
+BENCHMARK_CAPTURE(BM_CalculateProbability, bruteforce_expert, ProbableSolver::Engine::Bruteforce, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbability, backtracking_expert, ProbableSolver::Engine::Backtracking, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbability, backtracking_expert_parallel, ProbableSolver::Engine::Backtracking, 30, 16, 99, 36, 0)->UseRealTime();
+BENCHMARK_CAPTURE(BM_CalculateProbability, profile_expert, ProbableSolver::Engine::Profile, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbability, model_counting_expert, ProbableSolver::Engine::ModelCounting, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbabilityUnchanged, backtracking_expert_unchanged, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbabilityCached, backtracking_expert_cached, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbability, sampling_expert, ProbableSolver::Engine::Sampling, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_CalculateProbability, profile_large, ProbableSolver::Engine::Profile, 100, 100, 2000, 1);
+BENCHMARK_CAPTURE(BM_CalculateProbability, model_counting_large, ProbableSolver::Engine::ModelCounting, 100, 100, 2000, 1);
+
+BENCHMARK(BM_CountWall<frontier::BacktrackingEnumerator>)->DenseRange(8, 24, 4)->Complexity();
+BENCHMARK(BM_CountWall<frontier::ProfileCounter>)->DenseRange(8, 24, 4)->Complexity();
@@ -0,0 +1,276 @@
+#include <solver/solver.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+
+// Seeds of one difficulty of the corpus
+struct Difficulty {
+    std::string name;
+    unsigned int width, height, mines;
+    std::vector<unsigned int> seeds;
+};
+
+// A baseline metric, and how much worse it may get, relative to its value
+// or, for rates, in absolute terms
+struct Metric {
+    double value;
+    double tolerance;
+};
+
+/**
+ * Read a corpus of lines like `name width height mines seed...`. Lines
+ * starting with # are comments.
+ */
+static std::vector<Difficulty> read_corpus(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open corpus " + path);
+    }
+
+    std::vector<Difficulty> corpus;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        Difficulty difficulty;
+        fields >> difficulty.name >> difficulty.width >> difficulty.height >> difficulty.mines;
+        for (unsigned int seed; fields >> seed;) {
+            difficulty.seeds.push_back(seed);
+        }
+        if (difficulty.seeds.empty()) {
+            throw std::runtime_error("No seeds for " + difficulty.name + " in corpus " + path);
+        }
+        corpus.push_back(std::move(difficulty));
+    }
+    return corpus;
+}
+
+/**
+ * Read a baseline of lines like `metric value tolerance`. A missing
+ * baseline is empty if `bootstrap` is set, so that a first one can be
+ * written, and an error otherwise.
+ */
+static std::map<std::string, Metric> read_baseline(const std::string& path, bool bootstrap) {
+    std::map<std::string, Metric> baseline;
+    std::ifstream in(path);
+    if (!in && !bootstrap) {
+        throw std::runtime_error("Cannot open baseline " + path + ", run with --update to write one");
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        Metric metric;
+        fields >> name >> metric.value >> metric.tolerance;
+        baseline[name] = metric;
+    }
+    return baseline;
+}
+
+// Least increase of a latency counted as a regression, whatever its
+// tolerance, as smaller changes are within the noise of the clock and the
+// scheduler
+constexpr double min_latency_change_us = 5.0;
+
+/**
+ * Check whether a metric is better when lower, like latencies.
+ */
+static bool lower_is_better(const std::string& name) {
+    return name.ends_with("_us");
+}
+
+/**
+ * Check whether a metric is a rate, which changes by absolute amounts
+ * rather than relative to its value.
+ */
+static bool is_rate(const std::string& name) {
+    return name.ends_with("_rate");
+}
+
+/**
+ * Get the tolerance of a rate over `games` games: how far it is above the
+ * lower end of its 95% Wilson score interval. Games of the corpus play out
+ * the same every run, but a drop within the interval is as likely to come
+ * from which seeds are in the corpus as from a worse solver.
+ */
+static double rate_tolerance(double rate, double games) {
+    constexpr double z = 1.96;
+    auto spread = z * std::sqrt(rate * (1 - rate) / games + z * z / (4 * games * games));
+    auto lower = (rate + z * z / (2 * games) - spread) / (1 + z * z / games);
+    return rate - lower;
+}
+
+/**
+ * Get the default tolerance of a new timing. Timings vary from run to run.
+ */
+static double default_tolerance(const std::string& name) {
+    return lower_is_better(name) ? 0.5 : 0.25;
+}
+
+/**
+ * Get the `p`th percentile of sorted move times in microseconds, by
+ * nearest rank.
+ */
+static double percentile(const std::vector<std::chrono::nanoseconds>& sorted, double p) {
+    auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    auto index = std::clamp<std::size_t>(rank, 1, sorted.size()) - 1;
+    return std::chrono::duration<double, std::micro>(sorted[index]).count();
+}
+
+// Timed passes over each difficulty after its warm-up pass: at least this
+// many, and more until they've taken min_passes_time
+constexpr unsigned int min_passes = 5;
+constexpr std::chrono::seconds min_passes_time { 2 };
+
+/**
+ * Get the median of some values.
+ */
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    auto middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+/**
+ * Solve every game of a difficulty once on this thread, and measure its
+ * metrics. Most moves take well under a microsecond, so only the tail
+ * latencies are measured.
+ */
+static std::map<std::string, double> measure_pass(const Difficulty& difficulty) {
+    auto wins = 0U;
+    std::chrono::nanoseconds elapsed { 0 };
+    std::vector<std::chrono::nanoseconds> move_times;
+    for (auto seed : difficulty.seeds) {
+        Minesweeper game(MinefieldGenerator(seed), difficulty.width, difficulty.height, difficulty.mines);
+        HeadlessSolver solver(game);
+        solver.set_record_moves(true);
+        auto result = solver.solve();
+
+        wins += result.won;
+        elapsed += result.elapsed;
+        move_times.insert(move_times.end(), result.move_times.begin(), result.move_times.end());
+    }
+    std::sort(move_times.begin(), move_times.end());
+
+    auto games = static_cast<double>(difficulty.seeds.size());
+    return {
+        { difficulty.name + ".win_rate", wins / games },
+        { difficulty.name + ".games_per_second", games / std::chrono::duration<double>(elapsed).count() },
+        { difficulty.name + ".move_p95_us", percentile(move_times, 0.95) },
+        { difficulty.name + ".move_p99_us", percentile(move_times, 0.99) }
+    };
+}
+
+/**
+ * Measure the metrics of a difficulty over repeated passes, after a
+ * warm-up pass whose metrics are dropped. Each metric is the median of the
+ * passes, so that one slow pass doesn't read as a regression. Games play
+ * out the same every pass, so win rates don't vary.
+ */
+static std::map<std::string, double> measure(const Difficulty& difficulty) {
+    measure_pass(difficulty);
+
+    std::map<std::string, std::vector<double>> passes;
+    auto start = std::chrono::steady_clock::now();
+    for (auto pass = 0U; pass < min_passes || std::chrono::steady_clock::now() - start < min_passes_time; pass++) {
+        for (auto &[name, value] : measure_pass(difficulty)) {
+            passes[name].push_back(value);
+        }
+    }
+
+    std::map<std::string, double> metrics;
+    for (auto &[name, values] : passes) {
+        metrics[name] = median(values);
+    }
+    return metrics;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <corpus> <baseline> [--update]" << std::endl;
+        return 2;
+    }
+    std::string corpus_path = argv[1];
+    std::string baseline_path = argv[2];
+    auto update = argc > 3 && std::string(argv[3]) == "--update";
+
+    std::vector<Difficulty> corpus;
+    std::map<std::string, Metric> baseline;
+    try {
+        corpus = read_corpus(corpus_path);
+        baseline = read_baseline(baseline_path, update);
+    } catch (const std::runtime_error& error) {
+        std::cerr << error.what() << std::endl;
+        return 2;
+    }
+
+    std::map<std::string, double> current, games;
+    for (auto &difficulty : corpus) {
+        current.merge(measure(difficulty));
+        games[difficulty.name + ".win_rate"] = difficulty.seeds.size();
+    }
+
+    if (update) {
+        // Rates get the tolerance of their game count, and timings keep
+        // the tolerances already in the baseline
+        std::ofstream out(baseline_path);
+        out << "# metric value tolerance\n";
+        for (auto &[name, value] : current) {
+            auto tolerance = is_rate(name) ? rate_tolerance(value, games[name])
+                : baseline.contains(name) ? baseline[name].tolerance : default_tolerance(name);
+            out << name << " " << value << " " << tolerance << "\n";
+        }
+        std::cout << "Wrote " << current.size() << " metrics to " << baseline_path << std::endl;
+        return 0;
+    }
+
+    auto regressed = 0U;
+    std::cout << std::left << std::setw(32) << "metric" << std::right
+        << std::setw(12) << "baseline" << std::setw(12) << "current" << std::setw(10) << "change" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (auto &[name, value] : current) {
+        std::cout << std::left << std::setw(32) << name << std::right;
+        if (!baseline.contains(name)) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << value << std::setw(10) << "-" << "  NEW\n";
+            continue;
+        }
+
+        // Rates change by points, everything else by percent
+        auto &metric = baseline[name];
+        auto unit = is_rate(name) ? " " : "%";
+        auto change = is_rate(name) ? value - metric.value
+            : metric.value == 0 ? 0.0 : 100 * (value - metric.value) / metric.value;
+        auto worse = lower_is_better(name) ? change : -change;
+        auto tolerance = is_rate(name) ? metric.tolerance : 100 * metric.tolerance;
+        auto noise = lower_is_better(name) && value - metric.value <= min_latency_change_us;
+        std::cout << std::setw(12) << metric.value << std::setw(12) << value
+            << std::setw(9) << std::showpos << change << std::noshowpos << unit;
+        if (worse > tolerance + 1e-9 && !noise) {
+            std::cout << "  REGRESSED (tolerance " << tolerance << unit << ")";
+            regressed++;
+        }
+        std::cout << "\n";
+    }
+
+    if (regressed > 0) {
+        std::cout << regressed << " metrics regressed against " << baseline_path << std::endl;
+        return 1;
+    }
+    std::cout << "No metrics regressed" << std::endl;
+}
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include <solver/solver.hpp>
+#include <solver/sle.hpp>
+#include "boards.hpp"
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+using minesweeper::benchmarks::first_guess;
+
+static void BM_SolverStateConstruct(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    for (auto _ : bm_state) {
+        SolverState constructed(game.get_field());
+        benchmark::DoNotOptimize(constructed);
+    }
+}
+
+static void BM_BasicPass(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    BasicSolver basic;
+    for (auto _ : bm_state) {
+        benchmark::DoNotOptimize(basic.flaggable(state));
+        benchmark::DoNotOptimize(basic.safe(state));
+    }
+}
+
+static void BM_AdvancedPass(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    AdvancedSolver advanced;
+    for (auto _ : bm_state) {
+        benchmark::DoNotOptimize(advanced.flaggable(state));
+        benchmark::DoNotOptimize(advanced.safe(state));
+    }
+}
+
+/**
+ * Build the system of linear equations of the hint edge at the first
+ * guess, one equation per hint.
+ */
+static sle::SystemOfLinearEquations hint_edge_equations(SolverState& state) {
+    sle::SystemOfLinearEquations equations;
+    for (auto hint : state.hint_edge()) {
+        sle::Coefficients coefficients;
+        for (auto node : hint->adjacent_covered()) {
+            coefficients.insert({ node, 1 });
+        }
+        equations.add_equation(coefficients, sle::Fraction { hint->adjacent_mines_left() });
+    }
+    return equations;
+}
+
+static void BM_ConvertRowEchelon(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    auto fresh = hint_edge_equations(state);
+    bm_state.counters["equations"] = fresh.equations().size();
+    for (auto _ : bm_state) {
+        auto equations = fresh;
+        equations.convert_row_echelon();
+        benchmark::DoNotOptimize(equations);
+    }
+}
+
+static void BM_Evaluate(benchmark::State& bm_state, unsigned int width, unsigned int height, unsigned int mines, unsigned int seed) {
+    auto [game, state] = first_guess(width, height, mines, seed);
+    auto equations = hint_edge_equations(state);
+    equations.convert_row_echelon();
+    auto independent = equations.independent_variables();
+    bm_state.counters["independent"] = independent.size();
+
+    // Every independent variable safe, which needn't be a valid solution
+    sle::Assignments inputs;
+    for (auto node : independent) {
+        inputs.insert({ node, 0 });
+    }
+    for (auto _ : bm_state) {
+        auto assignments = inputs;
+        equations.evaluate(assignments);
+        benchmark::DoNotOptimize(assignments);
+    }
+}
+
+// Seeds are picked so that the first guess has a non-trivial hint edge
+BENCHMARK_CAPTURE(BM_SolverStateConstruct, beginner, 9, 9, 10, 5);
+BENCHMARK_CAPTURE(BM_SolverStateConstruct, expert, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_BasicPass, beginner, 9, 9, 10, 5);
+BENCHMARK_CAPTURE(BM_BasicPass, expert, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_AdvancedPass, beginner, 9, 9, 10, 5);
+BENCHMARK_CAPTURE(BM_AdvancedPass, expert, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_ConvertRowEchelon, intermediate, 16, 16, 40, 39);
+BENCHMARK_CAPTURE(BM_ConvertRowEchelon, expert, 30, 16, 99, 36);
+BENCHMARK_CAPTURE(BM_Evaluate, intermediate, 16, 16, 40, 39);
+BENCHMARK_CAPTURE(BM_Evaluate, expert, 30, 16, 99, 36);
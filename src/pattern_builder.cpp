@@ -0,0 +1,83 @@
+#include <solver/solver.hpp>
+#include <solver/patterns.hpp>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+
+/**
+ * Play a seeded game to the end, adding the canonical form of every small
+ * hint edge component seen along the way to `patterns`.
+ */
+static void collect(unsigned int seed, unsigned int width, unsigned int height, unsigned int mines, unsigned int max_cells, std::map<frontier::ComponentCache::Key, frontier::Counts>& patterns) {
+    Minesweeper game(MinefieldGenerator(seed), width, height, mines);
+    SolverState state(game.get_field());
+    auto game_state = game.uncover_tile(width/2, height/2);
+    state.update(state.get_node(width/2, height/2), game.get_field());
+
+    BasicSolver basic;
+    AdvancedSolver advanced;
+    ProbableSolver probable;
+    frontier::BacktrackingEnumerator enumerator;
+    while (game_state == Minesweeper::GameState::Continue) {
+        for (auto &component : frontier::components(state.hint_edge())) {
+            if (component.cells.size() > max_cells) {
+                continue;
+            }
+            auto canonical = frontier::PatternDatabase::canonical(component);
+            if (!patterns.contains(canonical.key)) {
+                auto counts = enumerator.count(frontier::PatternDatabase::reorder(component, canonical));
+                patterns.insert({ canonical.key, counts });
+            }
+        }
+
+        auto flaggable = basic.flaggable(state);
+        flaggable.merge(advanced.flaggable(state));
+        for (auto node : flaggable) {
+            auto [x, y] = node->coord();
+            game.toggle_flag(x, y);
+            state.update(node, game.get_field());
+        }
+
+        auto safe = basic.safe(state);
+        safe.merge(advanced.safe(state));
+        if (safe.empty()) {
+            safe.insert(probable.solve(state, game.mines_left()));
+        }
+        for (auto node : safe) {
+            auto [x, y] = node->coord();
+            game_state = game.uncover_tile(x, y);
+            state.update(node, game.get_field());
+            if (game_state != Minesweeper::GameState::Continue) {
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output> [games] [max cells] [width height mines]" << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    auto games = argc > 2 ? std::stoul(argv[2]) : 1000UL;
+    auto max_cells = argc > 3 ? std::stoul(argv[3]) : 12UL;
+    unsigned int width = 30, height = 16, mines = 99;
+    if (argc > 6) {
+        width = std::stoul(argv[4]);
+        height = std::stoul(argv[5]);
+        mines = std::stoul(argv[6]);
+    }
+
+    std::map<frontier::ComponentCache::Key, frontier::Counts> patterns;
+    for (auto seed = 0UL; seed < games; seed++) {
+        collect(seed, width, height, mines, max_cells, patterns);
+    }
+
+    frontier::PatternDatabase::write(output, { patterns.begin(), patterns.end() });
+    std::cout << "Wrote " << patterns.size() << " patterns from " << games << " games to " << output << std::endl;
+}
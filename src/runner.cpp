@@ -1,5 +1,6 @@
 #include <solver/solver.hpp>
 #include <iostream>
+#include <string>
 #include <tuple>
 
 struct GameParameters {
@@ -33,7 +34,7 @@ GameParameters custom_input() {
     return params;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     // Get height, width, num mines (or give options: Beginner, intermediate, expert)
     std::cout << "Welcome to the Minesweeper solver!\n";
     std::cout << "[1] Beginner (9x9 - 10 mines)\n";
@@ -76,8 +77,24 @@ int main() {
 
     auto animation_delay = get_number_input("Animation delay (ms)", 0);
 
+    // Optional --async flag to draw on a separate thread, then an optional
+    // pattern database built by pattern_builder
+    auto async = argc > 1 && std::string(argv[1]) == "--async";
+    auto patterns_path = argc > 1 + async ? argv[1 + async] : nullptr;
+
     minesweeper::Minesweeper game(chosen.width, chosen.height, chosen.mines);
-    minesweeper::solver::StateLogger logger(animation_delay);
-    minesweeper::solver::MinesweeperSolver solver(game, logger);
-    solver.solve();
+    auto solve = [&](auto solver) {
+        if (patterns_path) {
+            solver.set_patterns(std::make_shared<minesweeper::solver::frontier::PatternDatabase>(patterns_path));
+        }
+        return solver.solve();
+    };
+    auto result = async
+        ? solve(minesweeper::solver::AsyncMinesweeperSolver(game, minesweeper::solver::AsyncStateLogger(animation_delay)))
+        : solve(minesweeper::solver::MinesweeperSolver(game, minesweeper::solver::StateLogger(animation_delay)));
+    if (!result.won) {
+        std::cout << "Oops! Clicked on a mine." << std::endl;
+        return 1;
+    }
+    std::cout << "Minefield Swept!" << std::endl;
 }
\ No newline at end of file
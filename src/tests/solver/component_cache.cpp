@@ -0,0 +1,106 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/component_cache.hpp>
+#include <solver/enumerator.hpp>
+
+using namespace minesweeper::solver::frontier;
+
+static Component one_one_wall() {
+    return {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1 }, 1 }, { { 0, 1, 2 }, 1 } }
+    };
+}
+
+static Component one_two_corner() {
+    return {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1 }, 1 }, { { 0, 1, 2 }, 2 } }
+    };
+}
+
+TEST(ComponentCacheTest, KeyIgnoresConstraintOrder) {
+    Component reordered {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 2, 1, 0 }, 1 }, { { 1, 0 }, 1 } }
+    };
+    EXPECT_EQ(ComponentCache::key(reordered), ComponentCache::key(one_one_wall()));
+    EXPECT_NE(ComponentCache::key(one_two_corner()), ComponentCache::key(one_one_wall()));
+}
+
+TEST(ComponentCacheTest, HitsAndMisses) {
+    ComponentCache cache(4);
+    auto key = ComponentCache::key(one_one_wall());
+    EXPECT_FALSE(cache.find(key));
+
+    Counts counts(3);
+    counts.solutions = { 0, 2, 0, 0 };
+    cache.insert(key, counts);
+    auto found = cache.find(key);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->solutions, counts.solutions);
+
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_DOUBLE_EQ(cache.hit_rate(), 0.5);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.hit_rate(), 0);
+}
+
+TEST(ComponentCacheTest, EvictsLeastRecentlyUsed) {
+    ComponentCache cache(2);
+    Component single { std::vector<minesweeper::solver::Node*>(1), { { { 0 }, 1 } } };
+    auto wall = ComponentCache::key(one_one_wall());
+    auto corner = ComponentCache::key(one_two_corner());
+    auto other = ComponentCache::key(single);
+
+    cache.insert(wall, Counts(3));
+    cache.insert(corner, Counts(3));
+    cache.find(wall);
+    cache.insert(other, Counts(1));
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(cache.find(wall));
+    EXPECT_FALSE(cache.find(corner));
+    EXPECT_TRUE(cache.find(other));
+}
+
+TEST(ComponentCacheTest, CopiesAreIndependent) {
+    ComponentCache cache(2);
+    auto wall = ComponentCache::key(one_one_wall());
+    auto corner = ComponentCache::key(one_two_corner());
+    cache.insert(wall, Counts(3));
+
+    auto copy = cache;
+    copy.insert(corner, Counts(3));
+    EXPECT_TRUE(copy.find(wall));
+    EXPECT_TRUE(copy.find(corner));
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_FALSE(cache.find(corner));
+
+    cache = copy;
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(cache.find(corner));
+}
+
+TEST(ComponentCacheTest, EnumeratorLooksUpRepeatedComponents) {
+    auto cache = std::make_shared<ComponentCache>(16);
+    BacktrackingEnumerator uncached;
+    BacktrackingEnumerator enumerator;
+    enumerator.set_cache(cache);
+
+    auto expected = uncached.count({ one_one_wall(), one_two_corner(), one_one_wall() });
+    auto counts = enumerator.count({ one_one_wall(), one_two_corner(), one_one_wall() });
+    EXPECT_EQ(cache.get(), enumerator.cache().get());
+    EXPECT_EQ(cache->misses(), 3);
+    EXPECT_EQ(cache->size(), 2);
+
+    auto nodes_visited = enumerator.nodes_visited();
+    counts = enumerator.count({ one_two_corner(), one_one_wall() });
+    EXPECT_EQ(enumerator.nodes_visited(), nodes_visited);
+    EXPECT_EQ(cache->hits(), 2);
+    EXPECT_EQ(counts[0].cell_mines, expected[1].cell_mines);
+    EXPECT_EQ(counts[1].cell_mines, expected[0].cell_mines);
+}
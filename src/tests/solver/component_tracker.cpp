@@ -0,0 +1,113 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/component_tracker.hpp>
+#include <solver/solver.hpp>
+
+using namespace minesweeper::solver;
+using namespace minesweeper::solver::frontier;
+
+class ComponentTrackerTest : public ::testing::Test {
+protected:
+    // Two components, at the top and bottom rows, four rows apart
+    minesweeper::Minefield field = {
+        { Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile(1),       Tile(1),       Tile(1) },
+        { Tile(0),       Tile(0),       Tile(0) },
+        { Tile(1),       Tile(1),       Tile(1) },
+        { Tile::Covered, Tile::Covered, Tile::Covered }
+    };
+
+    static Counts counts(const Component& component) {
+        Counts counts(component.cells.size());
+        counts.solutions[1] = 1;
+        return counts;
+    }
+
+    static void expect_same(const std::vector<Component>& tracked, const std::vector<Component>& rebuilt) {
+        ASSERT_EQ(tracked.size(), rebuilt.size());
+        for (auto c = 0U; c < tracked.size(); c++) {
+            EXPECT_EQ(tracked[c].cells, rebuilt[c].cells);
+            ASSERT_EQ(tracked[c].constraints.size(), rebuilt[c].constraints.size());
+            for (auto i = 0U; i < tracked[c].constraints.size(); i++) {
+                EXPECT_EQ(tracked[c].constraints[i].cells, rebuilt[c].constraints[i].cells);
+                EXPECT_EQ(tracked[c].constraints[i].mines, rebuilt[c].constraints[i].mines);
+            }
+        }
+    }
+};
+
+TEST_F(ComponentTrackerTest, KeepsComponentsFarFromChanges) {
+    SolverState state(field);
+    ComponentTracker tracker;
+    auto components = tracker.components(state.hint_edge(), state.changes());
+    ASSERT_EQ(components.size(), 2);
+    tracker.update(components, { counts(components[0]), counts(components[1]) });
+
+    // Only the bottom component is within two cells of the flag
+    auto flagged = field;
+    flagged[4][1] = Tile::Flag;
+    state.update(state.get_node(4, 1), flagged);
+
+    components = tracker.components(state.hint_edge(), state.changes());
+    expect_same(components, frontier::components(state.hint_edge()));
+    auto found = tracker.find(components);
+    EXPECT_TRUE(found[0].has_value());
+    EXPECT_FALSE(found[1].has_value());
+    EXPECT_EQ(tracker.reused(), 1);
+    EXPECT_EQ(tracker.counted(), 1);
+}
+
+TEST_F(ComponentTrackerTest, NewStateRebuildsEverything) {
+    SolverState state(field);
+    ComponentTracker tracker;
+    auto components = tracker.components(state.hint_edge(), state.changes());
+    tracker.update(components, { counts(components[0]), counts(components[1]) });
+
+    SolverState other(field);
+    components = tracker.components(other.hint_edge(), other.changes());
+    expect_same(components, frontier::components(other.hint_edge()));
+    auto found = tracker.find(components);
+    EXPECT_FALSE(found[0].has_value());
+    EXPECT_FALSE(found[1].has_value());
+}
+
+TEST_F(ComponentTrackerTest, UncountedComponentsStayDirty) {
+    SolverState state(field);
+    ComponentTracker tracker;
+    auto components = tracker.components(state.hint_edge(), state.changes());
+    tracker.update(components, { counts(components[0]), std::nullopt });
+
+    components = tracker.components(state.hint_edge(), state.changes());
+    auto found = tracker.find(components);
+    EXPECT_TRUE(found[0].has_value());
+    EXPECT_FALSE(found[1].has_value());
+
+    tracker.clear();
+    components = tracker.components(state.hint_edge(), state.changes());
+    found = tracker.find(components);
+    EXPECT_FALSE(found[0].has_value());
+}
+
+TEST_F(ComponentTrackerTest, MatchesRebuildThroughoutGame) {
+    minesweeper::Minefield solution = {
+        { Tile(0), Tile(0), Tile(0), Tile(0), Tile(1), Tile::Flag },
+        { Tile(0), Tile(1), Tile(1), Tile(1), Tile(1), Tile(1) },
+        { Tile(0), Tile(1), Tile::Flag, Tile(1), Tile(0), Tile(0) },
+        { Tile(1), Tile(2), Tile(1), Tile(1), Tile(0), Tile(0) },
+        { Tile::Flag, Tile(1), Tile(0), Tile(1), Tile(1), Tile(1) },
+        { Tile(1), Tile(1), Tile(0), Tile(1), Tile::Flag, Tile(1) }
+    };
+    minesweeper::Minefield covered(6, std::vector<Tile>(6, Tile::Covered));
+    SolverState state(covered);
+    ComponentTracker tracker;
+
+    std::vector<std::pair<unsigned int, unsigned int>> moves = {
+        { 0, 4 }, { 1, 5 }, { 3, 0 }, { 5, 5 }, { 3, 3 }, { 1, 1 }, { 4, 1 },
+        { 2, 2 }, { 3, 1 }, { 5, 4 }, { 0, 0 }, { 4, 0 }, { 2, 5 }, { 0, 5 }
+    };
+    for (auto [x, y] : moves) {
+        state.update(state.get_node(x, y), solution);
+        auto components = tracker.components(state.hint_edge(), state.changes());
+        expect_same(components, frontier::components(state.hint_edge()));
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <solver/frontier.hpp>
+
+namespace minesweeper::tests {
+    /**
+     * Build two rows of covered cells along a wall of 1-2 hints, a long and
+     * thin component like those of Expert boards.
+     * 
+     * @param length number of cells in each row
+     * 
+     * @return component of 2 * `length` cells
+     */
+    inline solver::frontier::Component wall(unsigned int length) {
+        solver::frontier::Component component { std::vector<solver::Node*>(2 * length), {} };
+        for (auto i = 0U; i + 2 < length; i++) {
+            component.constraints.push_back({ { i, i + 1, i + 2, i + length, i + length + 1, i + length + 2 }, 1 + i % 2 });
+        }
+        return component;
+    }
+}
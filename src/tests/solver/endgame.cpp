@@ -0,0 +1,69 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/solver.hpp>
+
+using ::testing::AnyOf;
+
+using namespace minesweeper::solver;
+using namespace minesweeper::solver::frontier;
+using minesweeper::Tile;
+
+TEST(EndgameSolverTest, Determined) {
+    minesweeper::Minefield field = { { Tile(1) }, { Tile::Covered }, { Tile::Covered } };
+    SolverState state(field);
+    EndgameSolver endgame;
+    auto move = endgame.solve(state.covered(), 1);
+
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->node, state.get_node(2, 0));
+    EXPECT_EQ(move->win_probability, 1.0);
+    EXPECT_EQ(endgame.solutions().size(), 1);
+}
+
+TEST(EndgameSolverTest, FiftyFifty) {
+    minesweeper::Minefield field = {
+        { Tile(1),       Tile(1) },
+        { Tile::Covered, Tile::Covered }
+    };
+    SolverState state(field);
+    EndgameSolver endgame;
+    auto move = endgame.solve(state.covered(), 1);
+
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->win_probability, 0.5);
+}
+
+TEST(EndgameSolverTest, PrefersInformativeGuess) {
+    // Every cell of a row of three is a mine with probability 1/3, but only
+    // an end cell tells where the mine is when it's safe
+    minesweeper::Minefield field = { { Tile::Covered }, { Tile::Covered }, { Tile::Covered } };
+    SolverState state(field);
+    EndgameSolver endgame;
+    auto move = endgame.solve(state.covered(), 1);
+
+    ASSERT_TRUE(move.has_value());
+    EXPECT_THAT(move->node, AnyOf(state.get_node(0, 0), state.get_node(2, 0)));
+    EXPECT_DOUBLE_EQ(move->win_probability, 2.0 / 3.0);
+    EXPECT_GT(endgame.positions(), 0);
+
+    ProbableSolver probable;
+    probable.set_endgame(true);
+    EXPECT_THAT(probable.solve(state, 1), AnyOf(state.get_node(0, 0), state.get_node(2, 0)));
+}
+
+TEST(EndgameSolverTest, NotAnEndgame) {
+    minesweeper::Minefield field(7, std::vector<Tile>(7, Tile::Covered));
+    SolverState state(field);
+    EndgameSolver endgame;
+    EXPECT_FALSE(endgame.solve(state.covered(), 10).has_value());
+
+    // More placements than can be searched
+    minesweeper::Minefield wide(6, std::vector<Tile>(6, Tile::Covered));
+    SolverState wide_state(wide);
+    EXPECT_FALSE(endgame.solve(wide_state.covered(), 10).has_value());
+
+    // No placement at all
+    minesweeper::Minefield inconsistent = { { Tile(2) }, { Tile::Covered } };
+    SolverState inconsistent_state(inconsistent);
+    EXPECT_FALSE(endgame.solve(inconsistent_state.covered(), 1).has_value());
+}
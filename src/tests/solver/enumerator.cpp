@@ -0,0 +1,156 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/enumerator.hpp>
+#include "components.hpp"
+
+using ::testing::ElementsAre;
+
+using namespace minesweeper::solver::frontier;
+using minesweeper::tests::wall;
+
+TEST(BacktrackingEnumeratorTest, SingleConstraint) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1, 2 }, 1 } }
+    };
+    BacktrackingEnumerator enumerator;
+    auto counts = enumerator.count(component);
+
+    EXPECT_THAT(counts.solutions, ElementsAre(0, 3, 0, 0));
+    EXPECT_THAT(counts.cell_mines[0], ElementsAre(0, 1, 0, 0));
+    EXPECT_EQ(counts.total(), 3);
+}
+
+TEST(BacktrackingEnumeratorTest, OneTwoWall) {
+    // 1 - 2 - 1 hints along a wall of 5 covered cells
+    Component component {
+        std::vector<minesweeper::solver::Node*>(5),
+        {
+            { { 0, 1, 2 }, 1 },
+            { { 1, 2, 3 }, 2 },
+            { { 2, 3, 4 }, 1 }
+        }
+    };
+    BacktrackingEnumerator enumerator;
+    auto counts = enumerator.count(component);
+
+    // A mine at 2 would leave the 2 short, so the mines must be at 1 and 3
+    EXPECT_EQ(counts.total(), 1);
+    EXPECT_THAT(counts.solutions, ElementsAre(0, 0, 1, 0, 0, 0));
+    EXPECT_EQ(counts.cell_total(1), 1);
+    EXPECT_EQ(counts.cell_total(3), 1);
+    EXPECT_EQ(counts.cell_total(2), 0);
+    EXPECT_GT(enumerator.nodes_visited(), 0);
+}
+
+TEST(BacktrackingEnumeratorTest, VaryingMines) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(4),
+        {
+            { { 0, 1 }, 1 },
+            { { 1, 2, 3 }, 1 }
+        }
+    };
+    BacktrackingEnumerator enumerator;
+    auto counts = enumerator.count(component);
+
+    // cell 1 is a mine (1 mine), or cell 0 and one of 2, 3 (2 mines)
+    EXPECT_THAT(counts.solutions, ElementsAre(0, 1, 2, 0, 0));
+    EXPECT_THAT(counts.cell_mines[0], ElementsAre(0, 0, 2, 0, 0));
+    EXPECT_THAT(counts.cell_mines[1], ElementsAre(0, 1, 0, 0, 0));
+    EXPECT_THAT(counts.cell_mines[2], ElementsAre(0, 0, 1, 0, 0));
+}
+
+TEST(BacktrackingEnumeratorTest, NoSolutions) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(2),
+        {
+            { { 0, 1 }, 2 },
+            { { 0 }, 0 }
+        }
+    };
+    BacktrackingEnumerator enumerator;
+
+    EXPECT_EQ(enumerator.count(component).total(), 0);
+}
+
+TEST(BacktrackingEnumeratorTest, ParallelMatchesSequential) {
+    // A wall of hints, plus a small component that isn't split
+    auto long_wall = wall(20);
+    Component small {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1, 2 }, 1 } }
+    };
+
+    BacktrackingEnumerator sequential;
+    BacktrackingEnumerator parallel(std::make_shared<minesweeper::solver::ThreadPool>(4));
+    auto expected = sequential.count({ long_wall, small });
+    auto counts = parallel.count({ long_wall, small });
+
+    ASSERT_EQ(counts.size(), 2);
+    EXPECT_GT(counts[0].total(), 0);
+    for (auto c = 0U; c < counts.size(); c++) {
+        EXPECT_EQ(counts[c].solutions, expected[c].solutions);
+        EXPECT_EQ(counts[c].cell_mines, expected[c].cell_mines);
+    }
+}
+
+TEST(BacktrackingEnumeratorTest, CountUntilDeadline) {
+    auto long_wall = wall(20);
+    Component small {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1, 2 }, 1 } }
+    };
+
+    // The wall can't be counted in no time, but the small component is
+    // counted before the clock is checked
+    BacktrackingEnumerator enumerator;
+    auto counts = enumerator.count_until({ long_wall, small }, Clock::now());
+    ASSERT_EQ(counts.size(), 2);
+    EXPECT_FALSE(counts[0]);
+    ASSERT_TRUE(counts[1]);
+    EXPECT_EQ(counts[1]->total(), 3);
+
+    auto expected = enumerator.count(long_wall);
+    counts = enumerator.count_until({ long_wall }, Clock::now() + std::chrono::hours(1));
+    ASSERT_TRUE(counts[0]);
+    EXPECT_EQ(counts[0]->solutions, expected.solutions);
+}
+
+TEST(ProbeEstimatorTest, SingleSolution) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(5),
+        {
+            { { 0, 1, 2 }, 1 },
+            { { 1, 2, 3 }, 2 },
+            { { 2, 3, 4 }, 1 }
+        }
+    };
+    ProbeEstimator estimator(1);
+    auto estimate = estimator.estimate(component, Clock::now(), 100, 100);
+
+    EXPECT_EQ(estimate.probes, 100);
+    EXPECT_THAT(estimate.counts.solutions, ElementsAre(0, 0, 1, 0, 0, 0));
+    EXPECT_EQ(estimate.counts.cell_total(1), 1);
+    EXPECT_EQ(estimate.counts.cell_total(2), 0);
+    EXPECT_THAT(estimate.margins, ElementsAre(0, 0, 0, 0, 0));
+}
+
+TEST(ProbeEstimatorTest, CloseToExact) {
+    auto long_wall = wall(12);
+    BacktrackingEnumerator enumerator;
+    auto expected = enumerator.count(long_wall);
+
+    ProbeEstimator estimator(1);
+    auto estimate = estimator.estimate(long_wall, Clock::now(), 5000, 5000);
+
+    EXPECT_NEAR(estimate.counts.total() / expected.total(), 1, 0.1);
+    for (auto i = 0U; i < long_wall.cells.size(); i++) {
+        auto p = expected.cell_total(i) / expected.total();
+        auto estimated = estimate.counts.cell_total(i) / estimate.counts.total();
+        if (p > 0 && p < 1) {
+            EXPECT_GT(estimate.margins[i], 0);
+        }
+        EXPECT_NEAR(estimated, p, 2 * estimate.margins[i] + 0.01);
+    }
+}
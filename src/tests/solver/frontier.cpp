@@ -0,0 +1,143 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/solver.hpp>
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+using ::testing::DoubleEq;
+
+using namespace minesweeper::solver;
+using namespace minesweeper::solver::frontier;
+
+TEST(FrontierCountsTest, Empty) {
+    Counts counts(3);
+
+    EXPECT_EQ(counts.solutions.size(), 4);
+    EXPECT_EQ(counts.cell_mines.size(), 3);
+    EXPECT_EQ(counts.total(), 0);
+}
+
+TEST(FrontierCountsTest, Totals) {
+    Counts counts(2);
+    counts.solutions = { 1, 2, 0 };
+    counts.cell_mines[0] = { 0, 1, 0 };
+    counts.cell_mines[1] = { 0, 1, 0 };
+
+    EXPECT_EQ(counts.total(), 3);
+    EXPECT_EQ(counts.cell_total(0), 1);
+}
+
+TEST(FrontierComponentsTest, SingleHint) {
+    minesweeper::Minefield field = {
+        { Tile::Covered, Tile(1),       Tile::Covered }
+    };
+    auto state = SolverState(field);
+    auto result = components(state.hint_edge());
+
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_THAT(result[0].cells, ElementsAre(
+        state.get_node(0, 0),
+        state.get_node(0, 2)
+    ));
+    ASSERT_EQ(result[0].constraints.size(), 1);
+    EXPECT_THAT(result[0].constraints[0].cells, ElementsAre(0, 1));
+    EXPECT_EQ(result[0].constraints[0].mines, 1);
+}
+
+TEST(FrontierComponentsTest, Separate) {
+    minesweeper::Minefield field = {
+        { Tile::Covered, Tile(1),       Tile(0),       Tile(1),       Tile::Covered },
+        { Tile::Covered, Tile(1),       Tile(0),       Tile(1),       Tile::Covered }
+    };
+    auto state = SolverState(field);
+    auto result = components(state.hint_edge());
+
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_THAT(result[0].cells, ElementsAre(state.get_node(0, 0), state.get_node(1, 0)));
+    EXPECT_THAT(result[1].cells, ElementsAre(state.get_node(0, 4), state.get_node(1, 4)));
+    EXPECT_EQ(result[0].constraints.size(), 2);
+    EXPECT_EQ(result[1].constraints.size(), 2);
+}
+
+TEST(FrontierComponentsTest, SharedCells) {
+    minesweeper::Minefield field = {
+        { Tile::Covered, Tile(2),       Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile(1) },
+        { Tile::Covered, Tile(2),       Tile::Covered }
+    };
+    auto state = SolverState(field);
+    auto result = components(state.hint_edge());
+
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].cells.size(), 6);
+    EXPECT_EQ(result[0].constraints.size(), 3);
+}
+
+class FrontierCombineTest : public ::testing::Test {
+protected:
+    // cell 1 is a mine (1 mine), or cell 0 and one of cells 2, 3 (2 mines)
+    Counts varying { 4 };
+
+    // exactly one of two cells is a mine
+    Counts pair { 2 };
+
+    virtual void SetUp() {
+        varying.solutions = { 0, 1, 2, 0, 0 };
+        varying.cell_mines[0] = { 0, 0, 2, 0, 0 };
+        varying.cell_mines[1] = { 0, 1, 0, 0, 0 };
+        varying.cell_mines[2] = { 0, 0, 1, 0, 0 };
+        varying.cell_mines[3] = { 0, 0, 1, 0, 0 };
+
+        pair.solutions = { 0, 2, 0 };
+        pair.cell_mines[0] = { 0, 1, 0 };
+        pair.cell_mines[1] = { 0, 1, 0 };
+    }
+};
+
+TEST_F(FrontierCombineTest, WeightedByInterior) {
+    // 1 mine on the frontier leaves C(2, 1) = 2 interior placements,
+    // 2 mines leave C(2, 0) = 1
+    auto probabilities = combine({ varying }, 2, 2);
+
+    EXPECT_TRUE(probabilities.weighted);
+    EXPECT_THAT(probabilities.cells[0], ElementsAre(
+        DoubleEq(0.5),
+        DoubleEq(0.5),
+        DoubleEq(0.25),
+        DoubleEq(0.25)
+    ));
+    EXPECT_DOUBLE_EQ(probabilities.interior, 0.25);
+}
+
+TEST_F(FrontierCombineTest, MultipleComponents) {
+    // The pair always uses 1 mine, so with 2 mines left the varying
+    // component must use exactly 1
+    auto probabilities = combine({ varying, pair }, 0, 2);
+
+    EXPECT_TRUE(probabilities.weighted);
+    EXPECT_THAT(probabilities.cells[0], ElementsAre(
+        DoubleEq(0),
+        DoubleEq(1),
+        DoubleEq(0),
+        DoubleEq(0)
+    ));
+    EXPECT_THAT(probabilities.cells[1], ElementsAre(DoubleEq(0.5), DoubleEq(0.5)));
+}
+
+TEST_F(FrontierCombineTest, LargeInterior) {
+    // Weights of C(10000, 2000) overflow a double, but their ratio doesn't
+    auto probabilities = combine({ varying }, 10000, 2001);
+
+    EXPECT_TRUE(probabilities.weighted);
+    EXPECT_NEAR(probabilities.cells[0][1], 1 / (1 + 2 * 2000.0 / 8001.0), 1e-9);
+    EXPECT_NEAR(probabilities.interior, 0.2, 1e-3);
+}
+
+TEST_F(FrontierCombineTest, Unweighted) {
+    // Too many mines left for the frontier and interior to hold
+    auto probabilities = combine({ pair }, 1, 5);
+
+    EXPECT_FALSE(probabilities.weighted);
+    EXPECT_THAT(probabilities.cells[0], ElementsAre(DoubleEq(0.5), DoubleEq(0.5)));
+    EXPECT_DOUBLE_EQ(probabilities.interior, 1);
+}
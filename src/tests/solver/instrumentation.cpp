@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <solver/instrumentation.hpp>
+#include <memory>
+
+using namespace minesweeper::solver;
+
+TEST(GameStatsTest, EmptyJson) {
+    GameStats stats;
+    EXPECT_EQ(stats.json(), "{\"phases\":{},\"systems\":0,\"equations\":0,\"independent_variables\":0,\"nodes_visited\":0,\"allocations\":0}");
+}
+
+TEST(GameStatsTest, Json) {
+    GameStats stats;
+    stats.phases[Phase::Basic] = { 3, std::chrono::nanoseconds(1500), 7 };
+    stats.phases[Phase::Probable] = { 1, std::chrono::nanoseconds(20), 1 };
+    stats.counting = { 2, 10, 4, 123 };
+    stats.allocations = 42;
+
+    EXPECT_EQ(stats.json(),
+        "{\"phases\":{"
+            "\"basic\":{\"passes\":3,\"time_ns\":1500,\"moves\":7},"
+            "\"probable\":{\"passes\":1,\"time_ns\":20,\"moves\":1}"
+        "},\"systems\":2,\"equations\":10,\"independent_variables\":4,\"nodes_visited\":123,\"allocations\":42}");
+}
+
+TEST(InstrumentationTest, Allocations) {
+    auto before = allocations();
+    auto allocated = std::make_unique<int>(1);
+    EXPECT_EQ(*allocated, 1);
+    if (instrumented) {
+        EXPECT_GT(allocations(), before);
+    } else {
+        EXPECT_EQ(allocations(), 0);
+    }
+}
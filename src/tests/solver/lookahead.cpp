@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/solver.hpp>
+
+using namespace minesweeper::solver;
+using namespace minesweeper::solver::frontier;
+using minesweeper::Tile;
+
+class LookaheadTest : public ::testing::Test {
+protected:
+    // One mine left, next to the hint in the corner, so every other cell is
+    // safe but only some reveal a 0
+    minesweeper::Minefield field = {
+        { Tile(1),       Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered, Tile::Covered }
+    };
+    SolverState state { field };
+
+    void SetUp() override {
+        ProbableSolver probable;
+        probable.calculate_probability(state, 1);
+    }
+};
+
+TEST_F(LookaheadTest, PrefersProgress) {
+    LookaheadPolicy policy(256, 4);
+    auto scores = policy.score(components(state.hint_edge()), state.covered(), 1);
+
+    ASSERT_EQ(scores.size(), 4);
+    EXPECT_EQ(scores[0].node, state.get_node(0, 3));
+    EXPECT_EQ(scores[0].survival, 1.0);
+    EXPECT_EQ(scores[0].progress, 1.0);
+
+    // Next to the corner's cells, a 0 is revealed only if they're safe
+    auto next_to_corner = std::find_if(scores.begin(), scores.end(), [this](auto &score) {
+        return score.node == state.get_node(0, 2);
+    });
+    ASSERT_NE(next_to_corner, scores.end());
+    EXPECT_GT(next_to_corner->progress, 0.0);
+    EXPECT_LT(next_to_corner->progress, 1.0);
+    for (auto i = 1U; i < scores.size(); i++) {
+        EXPECT_GE(scores[i - 1].value(), scores[i].value());
+    }
+}
+
+TEST_F(LookaheadTest, SameOnAnyThreads) {
+    LookaheadPolicy single(200, 8, 7);
+    LookaheadPolicy parallel(200, 8, 7, std::make_shared<ThreadPool>(3));
+    auto expected = single.score(components(state.hint_edge()), state.covered(), 1);
+    auto scores = parallel.score(components(state.hint_edge()), state.covered(), 1);
+
+    ASSERT_EQ(scores.size(), expected.size());
+    for (auto i = 0U; i < scores.size(); i++) {
+        EXPECT_EQ(scores[i].node, expected[i].node);
+        EXPECT_EQ(scores[i].progress, expected[i].progress);
+    }
+}
+
+TEST_F(LookaheadTest, ProbableSolverGuess) {
+    ProbableSolver probable;
+    probable.set_lookahead(64, 4);
+    EXPECT_EQ(probable.solve(state, 1), state.get_node(0, 3));
+    EXPECT_EQ(probable.guess_scores().size(), 4);
+
+    probable.set_lookahead(0);
+    probable.solve(state, 1);
+    EXPECT_TRUE(probable.guess_scores().empty());
+}
@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/model_counter.hpp>
+#include <solver/enumerator.hpp>
+#include "components.hpp"
+
+using ::testing::ElementsAre;
+
+using namespace minesweeper::solver::frontier;
+using minesweeper::tests::wall;
+
+TEST(ModelCounterTest, SingleConstraint) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1, 2 }, 1 } }
+    };
+    ModelCounter counter;
+    auto counts = counter.count(component);
+
+    EXPECT_THAT(counts.solutions, ElementsAre(0, 3, 0, 0));
+    EXPECT_THAT(counts.cell_mines[2], ElementsAre(0, 1, 0, 0));
+}
+
+TEST(ModelCounterTest, Propagation) {
+    // 1 - 2 - 1 along a wall needs no decisions
+    Component component {
+        std::vector<minesweeper::solver::Node*>(5),
+        {
+            { { 0, 1, 2 }, 1 },
+            { { 1, 2, 3 }, 2 },
+            { { 2, 3, 4 }, 1 }
+        }
+    };
+    ModelCounter counter;
+    auto counts = counter.count(component);
+
+    EXPECT_EQ(counts.total(), 1);
+    EXPECT_EQ(counts.cell_total(1), 1);
+    EXPECT_EQ(counts.cell_total(3), 1);
+    EXPECT_GT(counter.decisions(), 0);
+}
+
+TEST(ModelCounterTest, NoModels) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(2),
+        { { { 0, 1 }, 2 }, { { 0 }, 0 } }
+    };
+    ModelCounter counter;
+    EXPECT_EQ(counter.count(component).total(), 0);
+}
+
+TEST(ModelCounterTest, MatchesBacktracking) {
+    // Two rows along a wall of 1-2 hints, and a dense block where every
+    // hint sees a 3x3 square of a 6x6 grid with mines on a diagonal pattern
+    auto long_wall = wall(20);
+    Component dense { std::vector<minesweeper::solver::Node*>(36), {} };
+    for (auto y = 0U; y + 2 < 6; y++) {
+        for (auto x = 0U; x + 2 < 6; x++) {
+            Constraint constraint { {}, 0 };
+            for (auto dy = 0U; dy < 3; dy++) {
+                for (auto dx = 0U; dx < 3; dx++) {
+                    constraint.cells.push_back((y + dy) * 6 + x + dx);
+                    constraint.mines += (2 * (x + dx) + y + dy) % 5 == 0;
+                }
+            }
+            dense.constraints.push_back(constraint);
+        }
+    }
+
+    for (auto &component : { long_wall, dense }) {
+        BacktrackingEnumerator enumerator;
+        ModelCounter counter;
+        auto expected = enumerator.count(component);
+        auto counts = counter.count(component);
+
+        EXPECT_GT(counts.total(), 0);
+        EXPECT_EQ(counts.solutions, expected.solutions);
+        EXPECT_EQ(counts.cell_mines, expected.cell_mines);
+    }
+}
+
+TEST(ModelCounterTest, CachesComponents) {
+    // Two identical halves joined by one cell split into the same residual
+    // once the joining cell is decided
+    Component component {
+        std::vector<minesweeper::solver::Node*>(7),
+        {
+            { { 0, 1, 2 }, 1 },
+            { { 2, 3 }, 1 },
+            { { 3, 4 }, 1 },
+            { { 4, 5, 6 }, 1 }
+        }
+    };
+    ModelCounter counter;
+    auto counts = counter.count(component);
+    BacktrackingEnumerator enumerator;
+    EXPECT_EQ(counts.cell_mines, enumerator.count(component).cell_mines);
+
+    auto misses = counter.cache().misses();
+    counter.count(component);
+    EXPECT_EQ(counter.cache().misses(), misses);
+    EXPECT_GT(counter.cache().hits(), 0);
+}
@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/numeric.hpp>
+#include <cmath>
+
+using ::testing::ElementsAre;
+using ::testing::DoubleNear;
+
+using namespace minesweeper::solver::numeric;
+
+TEST(LogDoubleTest, Arithmetic) {
+    LogDouble six { 6 };
+    LogDouble two { 2 };
+
+    EXPECT_NEAR((six + two).value(), 8, 1e-12);
+    EXPECT_NEAR((six - two).value(), 4, 1e-12);
+    EXPECT_NEAR((six * two).value(), 12, 1e-12);
+    EXPECT_NEAR((six / two).value(), 3, 1e-12);
+    EXPECT_LT(two, six);
+}
+
+TEST(LogDoubleTest, Zero) {
+    LogDouble zero;
+    LogDouble two { 2 };
+
+    EXPECT_EQ(zero.value(), 0);
+    EXPECT_EQ((zero + two).value(), 2);
+    EXPECT_EQ((zero * two).value(), 0);
+    EXPECT_LT(zero, two);
+}
+
+TEST(LogDoubleTest, SubtractionSaturates) {
+    LogDouble two { 2 };
+    LogDouble three { 3 };
+
+    EXPECT_EQ((two - three).value(), 0);
+    EXPECT_EQ((two - two).value(), 0);
+}
+
+TEST(LogDoubleTest, BeyondDouble) {
+    // e^1000 overflows a double, but ratios of such numbers don't
+    auto huge = LogDouble::from_log(1000);
+    auto larger = huge * LogDouble(4);
+
+    EXPECT_TRUE(std::isinf(huge.value()));
+    EXPECT_NEAR((huge / larger).value(), 0.25, 1e-12);
+    EXPECT_NEAR((huge / (huge + larger)).value(), 0.2, 1e-12);
+}
+
+TEST(NumericPolicyTest, BinomialsScaledAlike) {
+    auto floating = Float::binomials(5, { 0, 1, 2 });
+    auto log = LogSpace::binomials(5, { 0, 1, 2 });
+    auto exact = Exact::binomials(5, { 0, 1, 2 });
+
+    EXPECT_NEAR(floating[1] / floating[0], 5, 1e-12);
+    EXPECT_NEAR(floating[2] / floating[0], 10, 1e-12);
+    EXPECT_NEAR(log[2].value(), 10, 1e-9);
+    EXPECT_THAT(exact, ElementsAre(1, 5, 10));
+}
+
+TEST(NumericPolicyTest, LargeBinomials) {
+    // C(10000, 2000) overflows a double
+    auto floating = Float::binomials(10000, { 2000, 2001 });
+    auto log = LogSpace::binomials(10000, { 2000, 2001 });
+
+    EXPECT_TRUE(std::isfinite(floating[0]));
+    EXPECT_NEAR(floating[1] / floating[0], 8000.0 / 2001.0, 1e-9);
+    EXPECT_NEAR((log[1] / log[0]).value(), 8000.0 / 2001.0, 1e-9);
+}
+
+TEST(NumericPolicyTest, ExactConversions) {
+    EXPECT_EQ(Exact::count(12), Exact::value_type(12));
+    EXPECT_EQ(Exact::from_double(0.25), Exact::value_type(1, 4));
+    EXPECT_EQ(Exact::from_double(1.0 / 3), Exact::value_type(1, 3));
+    EXPECT_DOUBLE_EQ(Exact::to_double(Exact::value_type(3, 8)), 0.375);
+    EXPECT_THROW(Exact::count(std::ldexp(1.0, 63)), std::overflow_error);
+}
@@ -0,0 +1,149 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/solver.hpp>
+#include <solver/patterns.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+using ::testing::UnorderedElementsAre;
+
+using namespace minesweeper::solver;
+using namespace minesweeper::solver::frontier;
+
+class PatternDatabaseTest : public ::testing::Test {
+protected:
+    // 1-2-2-1 along a wall, and the same pattern turned on its side
+    minesweeper::Minefield wall_field = {
+        { Tile::Covered, Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile(1),       Tile(2),       Tile(2),       Tile(1) }
+    };
+    minesweeper::Minefield turned_field = {
+        { Tile(1), Tile::Covered },
+        { Tile(2), Tile::Covered },
+        { Tile(2), Tile::Covered },
+        { Tile(1), Tile::Covered }
+    };
+    // A file of each test's own, so tests run in parallel don't rewrite
+    // each other's mapped files
+    std::string path = testing::TempDir() + "patterns_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".db";
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void write_patterns(SolverState& state) {
+        BacktrackingEnumerator enumerator;
+        std::vector<std::pair<ComponentCache::Key, Counts>> patterns;
+        for (auto &component : components(state.hint_edge())) {
+            auto canonical = PatternDatabase::canonical(component);
+            patterns.push_back({ canonical.key, enumerator.count(PatternDatabase::reorder(component, canonical)) });
+        }
+        PatternDatabase::write(path, patterns);
+    }
+
+    // Overwrite the bytes of the database file at `offset` with `value`
+    template <typename T>
+    void patch(std::streamoff offset, T value) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+TEST_F(PatternDatabaseTest, CanonicalUnderSymmetry) {
+    auto wall = SolverState(wall_field);
+    auto turned = SolverState(turned_field);
+    auto wall_components = components(wall.hint_edge());
+    auto turned_components = components(turned.hint_edge());
+    ASSERT_EQ(wall_components.size(), 1);
+    ASSERT_EQ(turned_components.size(), 1);
+
+    EXPECT_EQ(PatternDatabase::canonical(wall_components[0]).key, PatternDatabase::canonical(turned_components[0]).key);
+}
+
+TEST_F(PatternDatabaseTest, MissingFileIsEmpty) {
+    PatternDatabase patterns(path);
+    auto wall = SolverState(wall_field);
+
+    EXPECT_EQ(patterns.size(), 0);
+    EXPECT_FALSE(patterns.find(components(wall.hint_edge())[0]));
+}
+
+TEST_F(PatternDatabaseTest, NotADatabase) {
+    std::ofstream(path) << "not a pattern database";
+    PatternDatabase patterns(path);
+    EXPECT_THROW(patterns.size(), std::runtime_error);
+}
+
+TEST_F(PatternDatabaseTest, OutOfBounds) {
+    // One pattern: the header, one index entry of (hash, offset) at 16, and
+    // a record of (key length, cell count, key, counts) at 32
+    auto wall = SolverState(wall_field);
+    write_patterns(wall);
+    auto size = std::filesystem::file_size(path);
+
+    std::filesystem::resize_file(path, size - 8);
+    EXPECT_THROW(PatternDatabase(path).size(), std::runtime_error);
+
+    write_patterns(wall);
+    patch<std::uint64_t>(8, 1000);
+    EXPECT_THROW(PatternDatabase(path).size(), std::runtime_error);
+
+    write_patterns(wall);
+    patch<std::uint64_t>(24, size);
+    EXPECT_THROW(PatternDatabase(path).size(), std::runtime_error);
+
+    write_patterns(wall);
+    patch<std::uint32_t>(32, 1 << 30);
+    EXPECT_THROW(PatternDatabase(path).size(), std::runtime_error);
+
+    write_patterns(wall);
+    patch<std::uint32_t>(36, ~std::uint32_t { 0 });
+    EXPECT_THROW(PatternDatabase(path).size(), std::runtime_error);
+
+    write_patterns(wall);
+    EXPECT_EQ(PatternDatabase(path).size(), 1);
+}
+
+TEST_F(PatternDatabaseTest, RewriteKeepsMappedFile) {
+    auto wall = SolverState(wall_field);
+    write_patterns(wall);
+    PatternDatabase patterns(path);
+    auto component = components(wall.hint_edge())[0];
+    ASSERT_TRUE(patterns.find(component));
+
+    // The mapped file is replaced, not truncated under it
+    PatternDatabase::write(path, {});
+    EXPECT_TRUE(patterns.find(component));
+    EXPECT_EQ(PatternDatabase(path).size(), 0);
+}
+
+TEST_F(PatternDatabaseTest, FindTurnedPattern) {
+    auto wall = SolverState(wall_field);
+    write_patterns(wall);
+
+    auto turned = SolverState(turned_field);
+    auto component = components(turned.hint_edge())[0];
+    BacktrackingEnumerator enumerator;
+    auto expected = enumerator.count(component);
+
+    PatternDatabase patterns(path);
+    EXPECT_EQ(patterns.size(), 1);
+    auto counts = patterns.find(component);
+    ASSERT_TRUE(counts);
+    EXPECT_EQ(counts->solutions, expected.solutions);
+    EXPECT_EQ(counts->cell_mines, expected.cell_mines);
+}
+
+TEST_F(PatternDatabaseTest, AdvancedSolverUsesPatterns) {
+    auto wall = SolverState(wall_field);
+    write_patterns(wall);
+
+    // The only solution has mines in the middle of the turned wall
+    auto turned = SolverState(turned_field);
+    AdvancedSolver advanced;
+    advanced.set_patterns(std::make_shared<PatternDatabase>(path));
+    EXPECT_THAT(advanced.flaggable(turned), UnorderedElementsAre(turned.get_node(1, 1), turned.get_node(2, 1)));
+    EXPECT_THAT(advanced.safe(turned), UnorderedElementsAre(turned.get_node(0, 1), turned.get_node(3, 1)));
+}
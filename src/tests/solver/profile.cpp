@@ -0,0 +1,72 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/profile.hpp>
+#include <solver/enumerator.hpp>
+#include "components.hpp"
+
+using ::testing::ElementsAre;
+
+using namespace minesweeper::solver::frontier;
+using minesweeper::tests::wall;
+
+TEST(ProfileCounterTest, SingleConstraint) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(3),
+        { { { 0, 1, 2 }, 1 } }
+    };
+    ProfileCounter profile;
+    auto counts = profile.count(component);
+
+    EXPECT_THAT(counts.solutions, ElementsAre(0, 3, 0, 0));
+    EXPECT_THAT(counts.cell_mines[0], ElementsAre(0, 1, 0, 0));
+}
+
+TEST(ProfileCounterTest, NoSolutions) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(2),
+        { { { 0, 1 }, 2 }, { { 0 }, 0 } }
+    };
+    ProfileCounter profile;
+    EXPECT_EQ(profile.count(component).total(), 0);
+}
+
+TEST(ProfileCounterTest, WallIsThin) {
+    // The width doesn't grow with the length of the wall
+    EXPECT_EQ(ProfileCounter::width(wall(20)), ProfileCounter::width(wall(200)));
+    EXPECT_LE(ProfileCounter::width(wall(200)), 4);
+}
+
+TEST(ProfileCounterTest, MatchesBacktracking) {
+    Component mixed {
+        std::vector<minesweeper::solver::Node*>(7),
+        {
+            { { 0, 1, 2 }, 1 },
+            { { 1, 2, 3, 4 }, 2 },
+            { { 4, 5 }, 1 },
+            { { 2, 5, 6 }, 1 }
+        }
+    };
+    for (auto &component : { wall(5), wall(12), mixed }) {
+        BacktrackingEnumerator enumerator;
+        ProfileCounter profile;
+        auto expected = enumerator.count(component);
+        auto counts = profile.count(component);
+
+        EXPECT_GT(counts.total(), 0);
+        EXPECT_EQ(counts.solutions, expected.solutions);
+        EXPECT_EQ(counts.cell_mines, expected.cell_mines);
+    }
+}
+
+TEST(ProfileCounterTest, TooWide) {
+    // Every pair of cells constrained together
+    Component dense { std::vector<minesweeper::solver::Node*>(40), {} };
+    for (auto i = 0U; i < 40; i++) {
+        for (auto j = i + 1; j < 40; j++) {
+            dense.constraints.push_back({ { i, j }, 1 });
+        }
+    }
+    ProfileCounter profile;
+    EXPECT_GT(ProfileCounter::width(dense), ProfileCounter::max_width);
+    EXPECT_THROW(profile.count(dense), std::invalid_argument);
+}
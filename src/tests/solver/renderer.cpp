@@ -0,0 +1,106 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/renderer.hpp>
+#include <sstream>
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+using namespace minesweeper;
+using namespace minesweeper::solver;
+
+TEST(FrameTest, Glyphs) {
+    Frame frame(3, 2);
+    frame.set(0, 0, Tile::Mine);
+    frame.set(1, 0, Tile::Flag);
+    frame.set(2, 0, static_cast<Tile>(0));
+    frame.set(0, 1, static_cast<Tile>(3));
+    frame.set_selected(0, 1);
+
+    EXPECT_EQ(frame.glyph(0, 0), '*');
+    EXPECT_EQ(frame.glyph(1, 0), 'f');
+    EXPECT_EQ(frame.glyph(2, 0), ' ');
+    EXPECT_EQ(frame.glyph(0, 1), '3');
+    EXPECT_EQ(frame.glyph(1, 1), 'O');
+    EXPECT_TRUE(frame.selected(0, 1));
+    EXPECT_FALSE(frame.selected(0, 0));
+}
+
+TEST(FrameRendererTest, FirstFrameRedraws) {
+    std::ostringstream out;
+    FrameRenderer renderer(out, std::chrono::milliseconds(0));
+    Frame frame(2, 2);
+    frame.set_mode("Basic");
+
+    EXPECT_TRUE(renderer.render(frame));
+    EXPECT_EQ(out.str(),
+        "\x1b[2J\x1b[1;1HSolve Mode in Use: Basic\x1b[K"
+        "\x1b[3;1HO O "
+        "\x1b[4;1HO O "
+        "\x1b[6;1H");
+}
+
+TEST(FrameRendererTest, OnlyChangedTiles) {
+    std::ostringstream out;
+    FrameRenderer renderer(out, std::chrono::milliseconds(0));
+    Frame frame(4, 3);
+    frame.set_mode("Basic");
+    renderer.render(frame);
+
+    frame.set(1, 1, static_cast<Tile>(2));
+    frame.set(2, 1, Tile::Flag);
+    frame.set(3, 2, static_cast<Tile>(0));
+    EXPECT_EQ(renderer.diff(frame), "\x1b[4;3H2 f \x1b[5;7H  \x1b[7;1H");
+
+    // Nothing is written when nothing changed
+    renderer.render(frame);
+    out.str("");
+    renderer.render(frame);
+    EXPECT_EQ(out.str(), "");
+}
+
+TEST(FrameRendererTest, SelectionAndMode) {
+    std::ostringstream out;
+    FrameRenderer renderer(out, std::chrono::milliseconds(0));
+    Frame frame(2, 1);
+    frame.set_mode("Basic");
+    frame.set_selected(0, 0);
+    renderer.render(frame);
+
+    frame.set_selected(1, 0);
+    frame.set_mode("Advanced");
+    auto diff = renderer.diff(frame);
+    EXPECT_THAT(diff, HasSubstr("Solve Mode in Use: Advanced"));
+    EXPECT_THAT(diff, HasSubstr("\x1b[3;1HO \x1b[32mO \x1b[0m"));
+    EXPECT_THAT(diff, Not(HasSubstr("\x1b[2J")));
+}
+
+TEST(FrameRendererTest, SizeChangeRedraws) {
+    std::ostringstream out;
+    FrameRenderer renderer(out, std::chrono::milliseconds(0));
+    renderer.render(Frame(2, 2));
+
+    EXPECT_THAT(renderer.diff(Frame(3, 2)), HasSubstr("\x1b[2J"));
+}
+
+TEST(FrameRendererTest, FrameRateHoldsBackFrames) {
+    std::ostringstream out;
+    FrameRenderer renderer(out, std::chrono::hours(1));
+    Frame frame(2, 1);
+    EXPECT_TRUE(renderer.render(frame));
+
+    frame.set(0, 0, Tile::Flag);
+    out.str("");
+    EXPECT_FALSE(renderer.render(frame));
+    frame.set(1, 0, Tile::Flag);
+    EXPECT_FALSE(renderer.render(frame));
+    EXPECT_EQ(out.str(), "");
+
+    // The latest frame held back is drawn by a flush
+    renderer.flush();
+    EXPECT_EQ(out.str(), "\x1b[3;1Hf f \x1b[5;1H");
+
+    out.str("");
+    renderer.flush();
+    EXPECT_EQ(out.str(), "");
+}
@@ -0,0 +1,69 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/ring_buffer.hpp>
+#include <thread>
+
+using namespace minesweeper::solver;
+
+TEST(RingBufferTest, FirstInFirstOut) {
+    RingBuffer<int, 4> ring;
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+
+    EXPECT_TRUE(ring.try_push(1));
+    EXPECT_TRUE(ring.try_push(2));
+    EXPECT_EQ(ring.size(), 2U);
+    EXPECT_EQ(ring.try_pop(), 1);
+    EXPECT_EQ(ring.try_pop(), 2);
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+}
+
+TEST(RingBufferTest, Full) {
+    RingBuffer<int, 4> ring;
+    for (auto i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(ring.size(), 4U);
+
+    EXPECT_EQ(ring.try_pop(), 0);
+    EXPECT_TRUE(ring.try_push(4));
+    for (auto i = 1; i <= 4; i++) {
+        EXPECT_EQ(ring.try_pop(), i);
+    }
+}
+
+TEST(RingBufferTest, WrapsAround) {
+    RingBuffer<int, 2> ring;
+    for (auto i = 0; i < 100; i++) {
+        EXPECT_TRUE(ring.try_push(i));
+        EXPECT_EQ(ring.try_pop(), i);
+    }
+    EXPECT_EQ(ring.size(), 0U);
+}
+
+TEST(RingBufferTest, AcrossThreads) {
+    constexpr auto count = 100000;
+    RingBuffer<int, 64> ring;
+    std::thread producer([&ring] {
+        for (auto i = 0; i < count;) {
+            if (ring.try_push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    auto in_order = true;
+    for (auto expected = 0; expected < count;) {
+        if (auto value = ring.try_pop()) {
+            in_order = in_order && *value == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+}
@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/sampler.hpp>
+#include <solver/enumerator.hpp>
+#include "components.hpp"
+
+using namespace minesweeper::solver::frontier;
+using minesweeper::tests::wall;
+
+TEST(MarkovChainSamplerTest, TooFewChains) {
+    EXPECT_THROW(MarkovChainSampler(0, 1000, 1), std::invalid_argument);
+    EXPECT_THROW(MarkovChainSampler(0, 1, 4), std::invalid_argument);
+}
+
+TEST(MarkovChainSamplerTest, NoSolutions) {
+    Component component {
+        std::vector<minesweeper::solver::Node*>(2),
+        { { { 0, 1 }, 2 }, { { 0 }, 0 } }
+    };
+    MarkovChainSampler sampler;
+    EXPECT_THROW(sampler.sample({ component }, 10, 5), std::invalid_argument);
+}
+
+TEST(MarkovChainSamplerTest, MatchesExact) {
+    std::vector<Component> components { wall(10), wall(6) };
+    BacktrackingEnumerator enumerator;
+    auto expected = combine(enumerator.count(components), 30, 15);
+
+    MarkovChainSampler sampler(1, 1000);
+    auto probabilities = sampler.sample(components, 30, 15);
+
+    EXPECT_TRUE(sampler.diagnostics().converged());
+    EXPECT_EQ(sampler.diagnostics().samples, 1000);
+    ASSERT_EQ(probabilities.cells.size(), 2);
+    for (auto c = 0U; c < components.size(); c++) {
+        for (auto i = 0U; i < components[c].cells.size(); i++) {
+            EXPECT_NEAR(probabilities.cells[c][i], expected.cells[c][i], 0.05);
+        }
+    }
+    EXPECT_NEAR(probabilities.interior, expected.interior, 0.02);
+}
+
+TEST(MarkovChainSamplerTest, SameSeedSameResult) {
+    std::vector<Component> components { wall(10) };
+    MarkovChainSampler first(7, 100), second(7, 100), other(8, 100);
+
+    auto probabilities = first.sample(components, 10, 8);
+    EXPECT_EQ(second.sample(components, 10, 8).cells, probabilities.cells);
+    EXPECT_NE(other.sample(components, 10, 8).cells, probabilities.cells);
+}
+
+TEST(MarkovChainSamplerTest, ConfigurationsKeepMineCount) {
+    std::vector<Component> components { wall(6), wall(4) };
+    MarkovChainSampler sampler(3, 100);
+    auto configurations = sampler.configurations(components, 10, 5, 100);
+
+    ASSERT_FALSE(configurations.empty());
+    EXPECT_LE(configurations.size(), 100);
+    for (auto &configuration : configurations) {
+        ASSERT_EQ(configuration.cells.size(), 20);
+        auto offset = 0U;
+        for (auto &component : components) {
+            for (auto &constraint : component.constraints) {
+                auto constraint_mines = 0U;
+                for (auto cell : constraint.cells) {
+                    constraint_mines += configuration.cells[offset + cell];
+                }
+                EXPECT_EQ(constraint_mines, constraint.mines);
+            }
+            offset += component.cells.size();
+        }
+        auto mines = std::count(configuration.cells.begin(), configuration.cells.end(), true);
+        EXPECT_EQ(mines + configuration.interior_mines, 5);
+    }
+}
@@ -4,6 +4,8 @@
 
 using ::testing::ElementsAre;
 using ::testing::UnorderedElementsAre;
+using ::testing::Pair;
+using ::testing::Each;
 
 using namespace minesweeper::solver::sle;
 using minesweeper::solver::Node;
@@ -182,4 +184,197 @@ TEST_F(SleTest, Evaluate) {
     system.convert_row_echelon();
     system.evaluate(assignments);
     EXPECT_EQ(assignments, expected);
-}
\ No newline at end of file
+}
+
+TEST_F(SleTest, CompileVariables) {
+    system.convert_row_echelon();
+    auto plan = system.compile({ nodes[3] });
+
+    EXPECT_EQ(plan.input_count(), 1);
+    EXPECT_EQ(plan.variables()[0], nodes[3]);
+    EXPECT_THAT(plan.variables(), UnorderedElementsAre(
+        nodes[0],
+        nodes[1],
+        nodes[2],
+        nodes[3]
+    ));
+}
+
+TEST_F(SleTest, CompileEvaluate) {
+    system.convert_row_echelon();
+    auto plan = system.compile({ nodes[3] });
+
+    std::vector<Fraction> values(plan.variables().size());
+    values[0] = Fraction{ 1, 3 };
+    plan.evaluate(values);
+
+    Assignments assignments;
+    for (auto slot = 0U; slot < values.size(); slot++) {
+        assignments.insert({ plan.variables()[slot], values[slot] });
+    }
+    Assignments expected {
+        {nodes[0], Fraction { 7, 15 }},
+        {nodes[1], Fraction { 6, 5 }},
+        {nodes[2], Fraction { -8, 15 }},
+        {nodes[3], Fraction { 1, 3 }}
+    };
+    EXPECT_EQ(assignments, expected);
+}
+
+TEST_F(SleTest, CompileNotEnoughInputs) {
+    system.convert_row_echelon();
+
+    EXPECT_THROW(system.compile({}), std::invalid_argument);
+}
+
+TEST_F(SleTest, EvaluatePlanWrongSize) {
+    system.convert_row_echelon();
+    auto plan = system.compile({ nodes[3] });
+
+    std::vector<Fraction> values(1);
+    EXPECT_THROW(plan.evaluate(values), std::invalid_argument);
+}
+
+TEST_F(SleTest, BatchEvaluate) {
+    SystemOfLinearEquations binary;
+    binary.add_equation({{ nodes[0], 1 }, { nodes[1], 1 }}, 2);
+    binary.add_equation({{ nodes[1], 1 }, { nodes[2], 1 }}, 1);
+    auto ind_vars = binary.independent_variables();
+    auto plan = binary.compile(ind_vars);
+    BatchEvaluator evaluator(plan);
+
+    EXPECT_EQ(evaluator.lane_inputs(), 1);
+    EXPECT_EQ(evaluator.batch_inputs(), 0);
+
+    // Only nodes[2] = 0 gives 0/1 values for the other variables
+    std::vector<std::uint64_t> mine_counts(plan.variables().size());
+    EXPECT_EQ(evaluator.evaluate({}, mine_counts), 1);
+
+    std::map<Node*, std::uint64_t> counts;
+    for (auto slot = 0U; slot < mine_counts.size(); slot++) {
+        counts.insert({ plan.variables()[slot], mine_counts[slot] });
+    }
+    EXPECT_THAT(counts, UnorderedElementsAre(
+        Pair(nodes[0], 1),
+        Pair(nodes[1], 1),
+        Pair(nodes[2], 0)
+    ));
+}
+
+TEST_F(SleTest, BatchEvaluateBatchInputs) {
+    // 8 independent variables, each equation has exactly one mine
+    SystemOfLinearEquations binary;
+    std::vector<Node*> vars;
+    for (unsigned long i = 0; i < 16; i++) {
+        vars.push_back((Node*) (i+1));
+    }
+    for (auto i = 0; i < 8; i++) {
+        binary.add_equation({{ vars[2*i], 1 }, { vars[2*i+1], 1 }}, 1);
+    }
+    auto plan = binary.compile(binary.independent_variables());
+    BatchEvaluator evaluator(plan);
+
+    EXPECT_EQ(evaluator.lane_inputs(), 6);
+    EXPECT_EQ(evaluator.batch_inputs(), 2);
+
+    std::vector<std::uint64_t> mine_counts(plan.variables().size());
+    std::uint64_t total = 0;
+    for (std::uint8_t a = 0; a < 2; a++) {
+        for (std::uint8_t b = 0; b < 2; b++) {
+            total += evaluator.evaluate({ a, b }, mine_counts);
+        }
+    }
+
+    EXPECT_EQ(total, 256);
+    EXPECT_THAT(mine_counts, Each(128));
+}
+
+TEST_F(SleTest, BatchEvaluateWrongSize) {
+    system.convert_row_echelon();
+    auto plan = system.compile({ nodes[3] });
+    BatchEvaluator evaluator(plan);
+
+    std::vector<std::uint64_t> mine_counts(1);
+    EXPECT_THROW(evaluator.evaluate({}, mine_counts), std::invalid_argument);
+}
+
+class IncrementalSleTest : public SleTest {
+    protected:
+    IncrementalSystemOfLinearEquations incremental;
+    std::array<Node*, 3> keys;
+
+    virtual void SetUp() {
+        SleTest::SetUp();
+        for (unsigned long i = 0; i < keys.size(); i++) {
+            keys[i] = (Node*) (i+100);
+        }
+    }
+};
+
+TEST_F(IncrementalSleTest, SetEquations) {
+    incremental.set_equation(keys[0], equation1.first, equation1.second);
+    incremental.set_equation(keys[1], equation2.first, equation2.second);
+    incremental.set_equation(keys[2], equation3.first, equation3.second);
+
+    system.convert_row_echelon();
+    EXPECT_EQ(incremental.equations(), system.equations());
+    EXPECT_EQ(incremental.independent_variables(), system.independent_variables());
+    EXPECT_THAT(incremental.keys(), UnorderedElementsAre(keys[0], keys[1], keys[2]));
+}
+
+TEST_F(IncrementalSleTest, Components) {
+    incremental.set_equation(keys[0], {{ nodes[0], 1 }, { nodes[1], 1 }}, 1);
+    incremental.set_equation(keys[1], {{ nodes[2], 1 }, { nodes[3], 1 }}, 1);
+    EXPECT_EQ(incremental.component_count(), 2);
+
+    incremental.set_equation(keys[2], {{ nodes[1], 1 }, { nodes[2], 1 }}, 1);
+    EXPECT_EQ(incremental.component_count(), 1);
+
+    incremental.remove_equation(keys[2]);
+    EXPECT_EQ(incremental.component_count(), 2);
+    EXPECT_THAT(incremental.independent_variables(), UnorderedElementsAre(nodes[1], nodes[3]));
+}
+
+TEST_F(IncrementalSleTest, UpdateEquation) {
+    incremental.set_equation(keys[0], equation1.first, equation1.second);
+    incremental.set_equation(keys[1], equation2.first, equation2.second);
+    incremental.set_equation(keys[1], equation3.first, equation3.second);
+
+    SystemOfLinearEquations expected;
+    expected.add_equation(equation1.first, equation1.second);
+    expected.add_equation(equation3.first, equation3.second);
+    expected.convert_row_echelon();
+
+    EXPECT_EQ(incremental.equations(), expected.equations());
+}
+
+TEST_F(IncrementalSleTest, RemoveEquation) {
+    incremental.set_equation(keys[0], equation1.first, equation1.second);
+    incremental.set_equation(keys[1], equation2.first, equation2.second);
+    incremental.equations();
+    incremental.remove_equation(keys[0]);
+
+    EXPECT_THAT(incremental.equations(), ElementsAre(equation2));
+    EXPECT_THAT(incremental.keys(), UnorderedElementsAre(keys[1]));
+}
+
+TEST_F(IncrementalSleTest, SystemCompiles) {
+    incremental.set_equation(keys[0], equation1.first, equation1.second);
+    incremental.set_equation(keys[1], equation2.first, equation2.second);
+    incremental.set_equation(keys[2], equation3.first, equation3.second);
+
+    auto plan = incremental.system().compile(incremental.independent_variables());
+    EXPECT_EQ(plan.input_count(), 1);
+    EXPECT_EQ(plan.variables().size(), 4);
+}
+
+TEST_F(SleTest, BatchEvaluateCoefficientsTooLarge) {
+    // The denominators fit, but scaling the coefficients to a common
+    // denominator doesn't
+    SystemOfLinearEquations large;
+    large.add_equation({{ nodes[0], 55580 }, { nodes[2], 6551 }}, 0);
+    large.add_equation({{ nodes[1], 41184 }, { nodes[0], 1 }, { nodes[3], 64326 }}, 0);
+    auto plan = large.compile(large.independent_variables());
+
+    EXPECT_THROW(BatchEvaluator evaluator(plan), std::overflow_error);
+}
@@ -1,13 +1,18 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <solver/solver.hpp>
+#include <sstream>
+#include <thread>
 
 using ::testing::UnorderedElementsAre;
 using ::testing::AnyOf;
 using ::testing::Pair;
+using ::testing::HasSubstr;
 
 using namespace minesweeper::solver;
 
+using Fraction = numeric::Exact::value_type;
+
 class SubSolverTest : public ::testing::Test {
 protected:
     minesweeper::Minefield init_field = {
@@ -16,9 +21,18 @@ protected:
         { Tile::Covered, Tile::Covered, Tile::Covered },
         { Tile::Covered, Tile::Covered, Tile::Covered }
     };
+
+    // Hint edge of several overlapping equations, with 5 mines left
+    minesweeper::Minefield many_equations_field = {
+        { Tile::Flag, Tile(3),       Tile(2),       Tile::Flag },
+        { Tile::Flag, Tile::Covered, Tile::Covered, Tile(2) },
+        { Tile::Flag, Tile(4),       Tile::Covered, Tile::Covered },
+        { Tile(1),    Tile(2),       Tile::Covered, Tile::Covered }
+    };
+
     BasicSolver basic;
     AdvancedSolver advanced;
-    ProbableSolver probable;
+    ExactProbableSolver probable;
 };
 
 TEST_F(SubSolverTest, BasicNoFlaggable) {
@@ -158,13 +172,13 @@ TEST_F(SubSolverTest, ProbableCalculate1LowMines) {
 
     Fraction one_fifth{1, 5};
     Fraction one_third{1, 3};
-    EXPECT_EQ(state.get_node(0, 0)->mine_probability(), one_fifth);
-    EXPECT_EQ(state.get_node(0, 2)->mine_probability(), one_fifth);
-    EXPECT_EQ(state.get_node(1, 0)->mine_probability(), one_fifth);
-    EXPECT_EQ(state.get_node(1, 1)->mine_probability(), one_fifth);
-    EXPECT_EQ(state.get_node(1, 2)->mine_probability(), one_fifth);
-    EXPECT_EQ(state.get_node(2, 1)->mine_probability(), one_third);
-    EXPECT_EQ(state.get_node(3, 2)->mine_probability(), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(0, 0)), one_fifth);
+    EXPECT_EQ(probable.probability(state.get_node(0, 2)), one_fifth);
+    EXPECT_EQ(probable.probability(state.get_node(1, 0)), one_fifth);
+    EXPECT_EQ(probable.probability(state.get_node(1, 1)), one_fifth);
+    EXPECT_EQ(probable.probability(state.get_node(1, 2)), one_fifth);
+    EXPECT_EQ(probable.probability(state.get_node(2, 1)), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(3, 2)), one_third);
 }
 
 TEST_F(SubSolverTest, ProbableCalculate) {
@@ -179,10 +193,10 @@ TEST_F(SubSolverTest, ProbableCalculate) {
 
     Fraction one_third {1, 3};
     Fraction two_thirds {2, 3};
-    EXPECT_EQ(state.get_node(0, 0)->mine_probability(), two_thirds);
-    EXPECT_EQ(state.get_node(1, 0)->mine_probability(), two_thirds);
-    EXPECT_EQ(state.get_node(1, 1)->mine_probability(), two_thirds);
-    EXPECT_EQ(state.get_node(2, 1)->mine_probability(), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(0, 0)), two_thirds);
+    EXPECT_EQ(probable.probability(state.get_node(1, 0)), two_thirds);
+    EXPECT_EQ(probable.probability(state.get_node(1, 1)), two_thirds);
+    EXPECT_EQ(probable.probability(state.get_node(2, 1)), one_third);
 }
 
 TEST_F(SubSolverTest, ProbableCalculateHard) {
@@ -198,31 +212,25 @@ TEST_F(SubSolverTest, ProbableCalculateHard) {
     Fraction one_half {1, 2};
     Fraction one_quarter {1, 4};
     Fraction three_quarters {3, 4};
-    EXPECT_EQ(state.get_node(0, 0)->mine_probability(), one_half);
-    EXPECT_EQ(state.get_node(0, 2)->mine_probability(), one_quarter);
-    EXPECT_EQ(state.get_node(1, 0)->mine_probability(), three_quarters);
-    EXPECT_EQ(state.get_node(1, 1)->mine_probability(), one_half);
-    EXPECT_EQ(state.get_node(2, 0)->mine_probability(), one_half);
-    EXPECT_EQ(state.get_node(2, 2)->mine_probability(), one_quarter);
+    EXPECT_EQ(probable.probability(state.get_node(0, 0)), one_half);
+    EXPECT_EQ(probable.probability(state.get_node(0, 2)), one_quarter);
+    EXPECT_EQ(probable.probability(state.get_node(1, 0)), three_quarters);
+    EXPECT_EQ(probable.probability(state.get_node(1, 1)), one_half);
+    EXPECT_EQ(probable.probability(state.get_node(2, 0)), one_half);
+    EXPECT_EQ(probable.probability(state.get_node(2, 2)), one_quarter);
 }
 
 TEST_F(SubSolverTest, ProbableCalculateManyEquations) {
-    minesweeper::Minefield probable_field = {
-        { Tile::Flag, Tile(3),       Tile(2),       Tile::Flag },
-        { Tile::Flag, Tile::Covered, Tile::Covered, Tile(2) },
-        { Tile::Flag, Tile(4),       Tile::Covered, Tile::Covered },
-        { Tile(1),    Tile(2),       Tile::Covered, Tile::Covered }
-    };
-    auto state = SolverState(probable_field);
+    auto state = SolverState(many_equations_field);
     probable.calculate_probability(state, 5);
 
     Fraction one_third {1, 3};
     Fraction two_thirds {2, 3};
-    EXPECT_EQ(state.get_node(1, 1)->mine_probability(), two_thirds);
-    EXPECT_EQ(state.get_node(1, 2)->mine_probability(), one_third);
-    EXPECT_EQ(state.get_node(2, 2)->mine_probability(), one_third);
-    EXPECT_EQ(state.get_node(2, 3)->mine_probability(), one_third);
-    EXPECT_EQ(state.get_node(3, 2)->mine_probability(), two_thirds);
+    EXPECT_EQ(probable.probability(state.get_node(1, 1)), two_thirds);
+    EXPECT_EQ(probable.probability(state.get_node(1, 2)), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(2, 2)), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(2, 3)), one_third);
+    EXPECT_EQ(probable.probability(state.get_node(3, 2)), two_thirds);
 }
 
 TEST_F(SubSolverTest, ProbableSolve1HighMines) {
@@ -241,6 +249,20 @@ TEST_F(SubSolverTest, ProbableSolve1HighMines) {
     ));
 }
 
+TEST_F(SubSolverTest, ProbableSolveTieBreak) {
+    minesweeper::Minefield probable_field = {
+        { Tile::Covered, Tile(1),       Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile::Covered }
+    };
+    auto state = SolverState(probable_field);
+    probable.set_endgame(false);
+
+    // Equally likely guesses go to the first in coordinate order
+    EXPECT_EQ(probable.solve(state, 5), state.get_node(0, 0));
+}
+
 TEST_F(SubSolverTest, ProbableSolveHard) {
     minesweeper::Minefield probable_hard_field = {
         { Tile::Covered, Tile(2),       Tile::Covered },
@@ -255,4 +277,379 @@ TEST_F(SubSolverTest, ProbableSolveHard) {
         state.get_node(0, 2),
         state.get_node(2, 2)
     ));
-}
\ No newline at end of file
+}
+
+TEST_F(SubSolverTest, ProbableCalculateAfterUpdate) {
+    minesweeper::Minefield probable_field = {
+        { Tile::Covered, Tile(2),       Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile(1) },
+        { Tile::Covered, Tile(2),       Tile::Covered }
+    };
+    minesweeper::Minefield updated_field = {
+        { Tile::Covered, Tile(2),       Tile::Covered },
+        { Tile::Covered, Tile::Covered, Tile(1) },
+        { Tile::Covered, Tile(2),       Tile(1) }
+    };
+    auto state = SolverState(probable_field);
+    probable.calculate_probability(state, 6);
+
+    // Equations of unchanged hints are reused from the previous call
+    state.update(state.get_node(2, 2), updated_field);
+    probable.calculate_probability(state, 6);
+
+    Fraction zero {0};
+    Fraction one_half {1, 2};
+    Fraction one {1};
+    EXPECT_EQ(probable.probability(state.get_node(0, 0)), one_half);
+    EXPECT_EQ(probable.probability(state.get_node(0, 2)), zero);
+    EXPECT_EQ(probable.probability(state.get_node(1, 0)), one_half);
+    EXPECT_EQ(probable.probability(state.get_node(1, 1)), one);
+    EXPECT_EQ(probable.probability(state.get_node(2, 0)), one_half);
+}
+
+TEST_F(SubSolverTest, ProbableCountsOnlyChangedComponents) {
+    minesweeper::Minefield probable_field = {
+        { Tile::Covered, Tile::Covered, Tile::Covered },
+        { Tile(1),       Tile(1),       Tile(1) },
+        { Tile(0),       Tile(0),       Tile(0) },
+        { Tile(1),       Tile(1),       Tile(1) },
+        { Tile::Covered, Tile::Covered, Tile::Covered }
+    };
+    minesweeper::Minefield updated_field = probable_field;
+    updated_field[4][1] = Tile::Flag;
+
+    auto state = SolverState(probable_field);
+    probable.calculate_probability(state, 2);
+    EXPECT_EQ(probable.component_tracker().counted(), 2);
+
+    // Only the component of the flagged cell is counted again
+    state.update(state.get_node(4, 1), updated_field);
+    probable.calculate_probability(state, 1);
+    EXPECT_EQ(probable.component_tracker().reused(), 1);
+    EXPECT_EQ(probable.component_tracker().counted(), 3);
+
+    std::map<Node*, Fraction> incremental;
+    for (auto node : state.covered()) {
+        incremental.insert({node, probable.probability(node)});
+    }
+    ExactProbableSolver fresh;
+    fresh.set_incremental(false);
+    fresh.calculate_probability(state, 1);
+    for (auto node : state.covered()) {
+        EXPECT_EQ(fresh.probability(node), incremental[node]);
+    }
+    EXPECT_EQ(fresh.component_tracker().counted(), 0);
+}
+
+TEST_F(SubSolverTest, ProbableEnginesAgree) {
+    auto state = SolverState(many_equations_field);
+    ExactProbableSolver bruteforce(ExactProbableSolver::Engine::Bruteforce);
+    ExactProbableSolver backtracking(ExactProbableSolver::Engine::Backtracking);
+
+    bruteforce.calculate_probability(state, 5);
+    std::map<Node*, Fraction> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, bruteforce.probability(node)});
+    }
+
+    backtracking.calculate_probability(state, 5);
+    for (auto node : state.covered()) {
+        EXPECT_EQ(backtracking.probability(node), expected[node]);
+    }
+}
+
+TEST_F(SubSolverTest, ProbableTimeBudget) {
+    auto state = SolverState(many_equations_field);
+    ExactProbableSolver unlimited;
+    ExactProbableSolver budgeted;
+    budgeted.set_time_budget(std::chrono::seconds(1));
+
+    unlimited.calculate_probability(state, 5);
+    std::map<Node*, Fraction> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, unlimited.probability(node)});
+    }
+
+    // A small hint edge is counted exactly well within the budget
+    budgeted.calculate_probability(state, 5);
+    EXPECT_TRUE(budgeted.exact());
+    EXPECT_EQ(budgeted.confidence().size(), state.covered_edge().size());
+    for (auto node : state.covered()) {
+        EXPECT_EQ(budgeted.probability(node), expected[node]);
+    }
+    for (auto &[node, interval] : budgeted.confidence()) {
+        EXPECT_EQ(interval.low, interval.high);
+        EXPECT_DOUBLE_EQ(interval.low, boost::rational_cast<double>(expected[node]));
+    }
+}
+
+TEST_F(SubSolverTest, ProbableTimeBudgetSeeded) {
+    // A row of hints between two rows of covered cells is too long to
+    // count in no time, so it is estimated, the same way by solvers with
+    // the same seed
+    auto mine = [](int x, int y) { return x >= 0 && x < 40 && (x * 7 + y * 3) % 5 < 2; };
+    auto mines_near = [&mine](int x) { return mine(x - 1, 0) + mine(x, 0) + mine(x + 1, 0) + mine(x - 1, 2) + mine(x, 2) + mine(x + 1, 2); };
+    minesweeper::Minefield wall_field(40, std::vector<Tile>(3, Tile::Covered));
+    for (auto x = 0U; x < wall_field.size(); x++) {
+        wall_field[x][1] = Tile(mines_near(x));
+    }
+    auto state = SolverState(wall_field);
+    ProbableSolver first, second;
+    first.set_time_budget(std::chrono::nanoseconds(1), 7);
+    second.set_time_budget(std::chrono::nanoseconds(1), 7);
+
+    first.calculate_probability(state, 40);
+    EXPECT_FALSE(first.exact());
+    std::map<Node*, double> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, first.probability(node)});
+    }
+
+    second.calculate_probability(state, 40);
+    for (auto node : state.covered()) {
+        EXPECT_EQ(second.probability(node), expected[node]);
+    }
+
+    ProbableSolver other;
+    other.set_time_budget(std::chrono::nanoseconds(1), 8);
+    other.calculate_probability(state, 40);
+    auto same = true;
+    for (auto node : state.covered()) {
+        same = same && other.probability(node) == expected[node];
+    }
+    EXPECT_FALSE(same);
+}
+
+TEST_F(SubSolverTest, ProbableSamplingNearExact) {
+    auto state = SolverState(many_equations_field);
+    ProbableSolver backtracking(ProbableSolver::Engine::Backtracking);
+    ProbableSolver sampling(ProbableSolver::Engine::Sampling);
+    sampling.set_sampler(frontier::MarkovChainSampler(1, 2000));
+
+    backtracking.calculate_probability(state, 5);
+    std::map<Node*, double> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, node->mine_probability()});
+    }
+
+    sampling.calculate_probability(state, 5);
+    EXPECT_TRUE(sampling.sampling_diagnostics().converged());
+    EXPECT_FALSE(sampling.exact());
+    EXPECT_TRUE(sampling.confidence().empty());
+    for (auto node : state.covered()) {
+        EXPECT_NEAR(node->mine_probability(), expected[node], 0.05);
+    }
+}
+
+TEST_F(SubSolverTest, ProbableProfileMatchesBacktracking) {
+    auto state = SolverState(many_equations_field);
+    ExactProbableSolver backtracking(ExactProbableSolver::Engine::Backtracking);
+    ExactProbableSolver profile(ExactProbableSolver::Engine::Profile);
+
+    backtracking.calculate_probability(state, 5);
+    std::map<Node*, Fraction> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, backtracking.probability(node)});
+    }
+
+    profile.calculate_probability(state, 5);
+    for (auto node : state.covered()) {
+        EXPECT_EQ(profile.probability(node), expected[node]);
+    }
+}
+
+TEST_F(SubSolverTest, ProbableModelCountingMatchesBacktracking) {
+    auto state = SolverState(many_equations_field);
+    ExactProbableSolver backtracking(ExactProbableSolver::Engine::Backtracking);
+    ExactProbableSolver counting(ExactProbableSolver::Engine::ModelCounting);
+
+    backtracking.calculate_probability(state, 5);
+    std::map<Node*, Fraction> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node, backtracking.probability(node)});
+    }
+
+    counting.calculate_probability(state, 5);
+    for (auto node : state.covered()) {
+        EXPECT_EQ(counting.probability(node), expected[node]);
+    }
+}
+
+TEST_F(SubSolverTest, ProbableCopiesOnThreads) {
+    // Copies share the pool but count with their own state
+    ExactProbableSolver original(ExactProbableSolver::Engine::ModelCounting, 2);
+    auto state = SolverState(many_equations_field);
+    original.calculate_probability(state, 5);
+    std::map<std::pair<unsigned int, unsigned int>, Fraction> expected;
+    for (auto node : state.covered()) {
+        expected.insert({node->coord(), original.probability(node)});
+    }
+
+    auto copy = original;
+    auto copy_state = SolverState(many_equations_field);
+    std::thread other([&] {
+        for (auto i = 0; i < 20; i++) {
+            copy.calculate_probability(copy_state, 5);
+        }
+    });
+    for (auto i = 0; i < 20; i++) {
+        original.calculate_probability(state, 5);
+    }
+    other.join();
+
+    for (auto node : copy_state.covered()) {
+        EXPECT_EQ(copy.probability(node), expected[node->coord()]);
+    }
+    for (auto node : state.covered()) {
+        EXPECT_EQ(original.probability(node), expected[node->coord()]);
+    }
+}
+
+template <typename Solver>
+static typename Solver::Engine engine(bool bruteforce) {
+    return bruteforce ? Solver::Engine::Bruteforce : Solver::Engine::Backtracking;
+}
+
+TEST_F(SubSolverTest, ProbableNumericPoliciesAgree) {
+    auto state = SolverState(many_equations_field);
+    for (auto bruteforce : { true, false }) {
+        ExactProbableSolver exact(engine<ExactProbableSolver>(bruteforce));
+        ProbableSolver floating(engine<ProbableSolver>(bruteforce));
+        LogProbableSolver log(engine<LogProbableSolver>(bruteforce));
+
+        exact.calculate_probability(state, 5);
+        std::map<Node*, double> expected;
+        for (auto node : state.covered()) {
+            expected.insert({node, boost::rational_cast<double>(exact.probability(node))});
+        }
+
+        floating.calculate_probability(state, 5);
+        for (auto node : state.covered()) {
+            EXPECT_NEAR(floating.probability(node), expected[node], 1e-12);
+            EXPECT_DOUBLE_EQ(node->mine_probability(), floating.probability(node));
+        }
+
+        log.calculate_probability(state, 5);
+        for (auto node : state.covered()) {
+            EXPECT_NEAR(log.probability(node).value(), expected[node], 1e-12);
+        }
+    }
+}
+
+TEST(MinesweeperSolverTest, OpeningEndsGame) {
+    // The opening move either hits the only mine or leaves only it covered
+    auto wins = 0U, losses = 0U;
+    for (auto seed = 0U; seed < 20; seed++) {
+        minesweeper::Minesweeper game(minesweeper::MinefieldGenerator(seed), 2, 1, 1);
+        HeadlessSolver solver(game);
+        auto result = solver.solve();
+
+        EXPECT_EQ(result.moves, 1);
+        EXPECT_EQ(result.guesses, 1);
+        EXPECT_THAT(result.phase_moves, UnorderedElementsAre(Pair(Phase::Opening, 1)));
+        wins += result.won;
+        losses += !result.won;
+    }
+    EXPECT_GT(wins, 0);
+    EXPECT_GT(losses, 0);
+}
+
+TEST(MinesweeperSolverTest, Cascade) {
+    minesweeper::Minesweeper game(3, 3, 0);
+    HeadlessSolver solver(game);
+    auto result = solver.solve();
+
+    EXPECT_TRUE(result.won);
+    EXPECT_EQ(result.moves, 1);
+}
+
+TEST(MinesweeperSolverTest, SolvesManyGames) {
+    // Games end with a result rather than ending the process
+    auto wins = 0U;
+    for (auto seed = 0U; seed < 10; seed++) {
+        minesweeper::Minesweeper game(minesweeper::MinefieldGenerator(seed), 9, 9, 10);
+        HeadlessSolver solver(game);
+        auto result = solver.solve();
+
+        auto phase_total = 0U;
+        for (auto &[phase, moves] : result.phase_moves) {
+            phase_total += moves;
+        }
+        EXPECT_EQ(phase_total, result.moves);
+        EXPECT_GE(result.guesses, 1);
+        EXPECT_LE(result.guesses, result.moves);
+        EXPECT_GT(result.elapsed.count(), 0);
+        if (instrumented) {
+            EXPECT_EQ(result.stats.phases[Phase::Opening].moves, 1);
+            EXPECT_GT(result.stats.allocations, 0);
+        } else {
+            EXPECT_TRUE(result.stats.phases.empty());
+        }
+        wins += result.won;
+    }
+    EXPECT_GT(wins, 0);
+}
+
+TEST(MinesweeperSolverTest, CacheKeptAcrossGames) {
+    // Components are counted into the given cache, not the process wide one
+    auto shared_lookups = frontier::ComponentCache::shared()->hits() + frontier::ComponentCache::shared()->misses();
+    auto cache = std::make_shared<frontier::ComponentCache>(1024);
+    for (auto seed = 0U; seed < 10; seed++) {
+        minesweeper::Minesweeper game(minesweeper::MinefieldGenerator(seed), 9, 9, 10);
+        HeadlessSolver solver(game);
+        solver.set_cache(cache);
+        solver.solve();
+    }
+    EXPECT_GT(cache->size(), 0);
+    EXPECT_GT(cache->hits(), 0);
+    EXPECT_EQ(frontier::ComponentCache::shared()->hits() + frontier::ComponentCache::shared()->misses(), shared_lookups);
+}
+
+TEST(MinesweeperSolverTest, AsyncLoggerDrawsFinalState) {
+    std::ostringstream out;
+    minesweeper::Minesweeper game(3, 3, 0);
+    AsyncMinesweeperSolver solver(game, AsyncStateLogger(0, out));
+    auto result = solver.solve();
+
+    // solve waits for the drawing thread, which has drawn the cascade
+    EXPECT_TRUE(result.won);
+    EXPECT_THAT(out.str(), HasSubstr("\x1b[3;1H      "));
+}
+
+TEST(MinesweeperSolverTest, AsyncLoggerSendsChangedTiles) {
+    std::ostringstream out;
+    AsyncStateLogger logger(0, out);
+    minesweeper::Minefield covered = { { Tile::Covered, Tile::Covered }, { Tile::Covered, Tile::Covered } };
+    minesweeper::Minefield revealed = { { Tile(1), Tile::Covered }, { Tile(2), Tile::Covered } };
+
+    SolverState state(covered);
+    state.set_selected(state.get_node(0, 0));
+    logger.log(state);
+    state.update(state.get_node(0, 0), revealed);
+    logger.log(state);
+    logger.flush();
+    EXPECT_THAT(out.str(), HasSubstr("\x1b[3;1H\x1b[32m1 "));
+
+    // Tiles of a new state weren't changed by an update, so its whole
+    // board is compared with what was sent
+    SolverState other(revealed);
+    other.set_selected(other.get_node(1, 0));
+    logger.log(other);
+    logger.flush();
+    EXPECT_THAT(out.str(), HasSubstr("1 \x1b[32m2 "));
+}
+
+TEST(MinesweeperSolverTest, AsyncLoggerSolvesManyGames) {
+    auto wins = 0U;
+    for (auto seed = 0U; seed < 5; seed++) {
+        std::ostringstream out;
+        minesweeper::Minesweeper game(minesweeper::MinefieldGenerator(seed), 16, 16, 40);
+        AsyncMinesweeperSolver solver(game, AsyncStateLogger(0, out));
+        auto result = solver.solve();
+
+        EXPECT_GE(result.moves, 1);
+        EXPECT_THAT(out.str(), HasSubstr("Solve Mode in Use: "));
+        wins += result.won;
+    }
+    EXPECT_GT(wins, 0);
+}
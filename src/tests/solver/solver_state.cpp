@@ -144,6 +144,24 @@ TEST_F(SolverStateTest, NumberEdge) {
     ));
 }
 
+TEST_F(SolverStateTest, Changes) {
+    auto changes = state->changes();
+    state->update(state->get_node(1, 0), field2);
+    state->update(state->get_node(1, 0), field2);
+    EXPECT_THAT(*changes, ::testing::ElementsAre(state->get_node(1, 0)));
+
+    SolverState copy = *state;
+    EXPECT_EQ(copy.changes(), changes);
+}
+
+TEST_F(SolverStateTest, CoveredAfterFlag) {
+    state->update(state->get_node(0, 0), field2);
+    state->update(state->get_node(0, 2), field2);
+    EXPECT_EQ(state->covered().size(), 7);
+    EXPECT_FALSE(state->covered().contains(state->get_node(0, 2)));
+    EXPECT_FALSE(state->covered_edge().contains(state->get_node(0, 2)));
+}
+
 TEST_F(SolverStateTest, ConstructorCoords) {
     EXPECT_THAT(state->get_node(0, 0)->coord(), Pair(0, 0));
     EXPECT_THAT(state->get_node(2, 2)->coord(), Pair(2, 2));
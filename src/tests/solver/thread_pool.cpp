@@ -0,0 +1,73 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/thread_pool.hpp>
+#include <stdexcept>
+#include <thread>
+
+using ::testing::Each;
+
+using namespace minesweeper::solver;
+
+TEST(ThreadPoolTest, Size) {
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3);
+}
+
+TEST(ThreadPoolTest, HardwareSize) {
+    ThreadPool pool;
+    EXPECT_GE(pool.size(), 1);
+}
+
+TEST(ThreadPoolTest, RunsAllTasks) {
+    ThreadPool pool(4);
+    std::vector<int> done(1000, 0);
+
+    std::vector<std::function<void()>> tasks;
+    for (auto i = 0U; i < done.size(); i++) {
+        tasks.push_back([&done, i] { done[i]++; });
+    }
+    pool.run(tasks);
+
+    EXPECT_THAT(done, Each(1));
+}
+
+TEST(ThreadPoolTest, RunsRepeatedly) {
+    ThreadPool pool(4);
+    std::atomic<int> count = 0;
+
+    for (auto run = 0; run < 50; run++) {
+        std::vector<std::function<void()>> tasks(10, [&count] { count++; });
+        pool.run(tasks);
+    }
+
+    EXPECT_EQ(count, 500);
+}
+
+TEST(ThreadPoolTest, ConcurrentCallersTakeTurns) {
+    auto pool = std::make_shared<ThreadPool>(2);
+    std::atomic<int> first = 0, second = 0;
+
+    auto caller = [&pool](std::atomic<int>& count) {
+        for (auto run = 0; run < 50; run++) {
+            std::vector<std::function<void()>> tasks(10, [&count] { count++; });
+            pool->run(tasks);
+        }
+    };
+    std::thread other(caller, std::ref(second));
+    caller(first);
+    other.join();
+
+    EXPECT_EQ(first, 500);
+    EXPECT_EQ(second, 500);
+}
+
+TEST(ThreadPoolTest, RethrowsTaskException) {
+    ThreadPool pool(2);
+    std::atomic<int> count = 0;
+
+    std::vector<std::function<void()>> tasks(10, [&count] { count++; });
+    tasks.push_back([] { throw std::runtime_error("task failed"); });
+
+    EXPECT_THROW(pool.run(tasks), std::runtime_error);
+    EXPECT_EQ(count, 10);
+}
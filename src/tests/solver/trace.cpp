@@ -0,0 +1,56 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <solver/trace.hpp>
+#include <sstream>
+#include <thread>
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+using namespace minesweeper::solver;
+
+TEST(TraceTest, NotRecording) {
+    trace::start();
+    trace::stop();
+    {
+        trace::Scope scope("ignored", "test");
+    }
+
+    std::ostringstream out;
+    trace::write(out);
+    EXPECT_FALSE(trace::active());
+    EXPECT_THAT(out.str(), HasSubstr("\"traceEvents\":["));
+    EXPECT_THAT(out.str(), Not(HasSubstr("ignored")));
+}
+
+TEST(TraceTest, Scopes) {
+    trace::start();
+    {
+        trace::Scope scope("move", "test", 3, 4);
+    }
+    std::thread([] {
+        trace::Scope scope("other thread", "test");
+    }).join();
+    trace::stop();
+
+    std::ostringstream out;
+    trace::write(out);
+    if (instrumented) {
+        EXPECT_THAT(out.str(), HasSubstr("\"name\":\"move\",\"cat\":\"test\",\"ph\":\"X\""));
+        EXPECT_THAT(out.str(), HasSubstr("\"args\":{\"x\":3,\"y\":4}"));
+        EXPECT_THAT(out.str(), HasSubstr("other thread"));
+    } else {
+        EXPECT_THAT(out.str(), Not(HasSubstr("\"name\"")));
+    }
+}
+
+TEST(TraceTest, StartClears) {
+    trace::start();
+    trace::complete("old", "test", trace::Clock::now(), trace::Clock::now());
+    trace::start();
+    trace::stop();
+
+    std::ostringstream out;
+    trace::write(out);
+    EXPECT_THAT(out.str(), Not(HasSubstr("old")));
+}